@@ -1,63 +1,17 @@
 #include "aco.h"
+#include "prune.h"
 #include <chrono>
-#include <cstring>
-#include <fstream>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <random>
-#include <sstream>
 
 using namespace std;
 
-// Parameter ranges
-#if DIMENSIONS == 4
-float pheromones[DIMENSIONS] = {1.0f, 1.0f, 1.0f, 1.0f};
+// Parameter ranges. The order-4 and order-6 boxes are the leading rows of the
+// order-8 box, so one table per PARAM_SET serves every DIMENSIONS.
 #if PARAM_SET == 0
-const float parameter_ranges[4][2] = {
-    {20000, 40000}, // theta[0]
-    {20000, 40000}, // theta[1]
-    {5, 10},        // theta[2]
-    {5, 10},        // theta[3]
-};
-#elif PARAM_SET == 1
-const float parameter_ranges[4][2] = {
-    {-500000, -200000}, // theta[0]
-    {2000000, 5000000}, // theta[1]
-    {0, 10},        // theta[2]
-    {0, 10},        // theta[3]
-};
-#else
-#error "Invalid PARAM_SET value. Must be 0, or 1."
-#endif
-
-#elif DIMENSIONS == 6
-float pheromones[DIMENSIONS] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
-#if PARAM_SET == 0
-const float parameter_ranges[6][2] = {
-    {20000, 40000}, // theta[0]
-    {20000, 40000}, // theta[1]
-    {5, 10},        // theta[2]
-    {5, 10},        // theta[3]
-    {-0.01, 0.01},  // theta[4]
-    {-0.01, 0.01},  // theta[5]
-};
-#elif PARAM_SET == 1
-const float parameter_ranges[6][2] = {
-    {-500000, -200000}, // theta[0]
-    {2000000, 5000000}, // theta[1]
-    {0, 10},        // theta[2]
-    {0, 10},        // theta[3]
-    {0, 0.001},  // theta[4]
-    {-0.001, 0},  // theta[5]
-};
-#else
-#error "Invalid PARAM_SET value. Must be 0, or 1."
-#endif
-
-#elif DIMENSIONS == 8
-float pheromones[DIMENSIONS] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
-#if PARAM_SET == 0
-const float parameter_ranges[8][2] = {
+extern const float parameter_ranges[MAX_DIMENSIONS][2] = {
     {20000, 40000},    // theta[0]
     {20000, 40000},    // theta[1]
     {5, 10},           // theta[2]
@@ -67,8 +21,8 @@ const float parameter_ranges[8][2] = {
     {-0.0001, 0.0001}, // theta[6]
     {-0.0001, 0.0001}, // theta[7]
 };
-#elif PARAM_SET == 1 
-const float parameter_ranges[8][2] = {
+#elif PARAM_SET == 1
+extern const float parameter_ranges[MAX_DIMENSIONS][2] = {
     {-500000, -200000}, // theta[0]
     {2000000, 5000000}, // theta[1]
     {0, 10},        // theta[2]
@@ -82,22 +36,8 @@ const float parameter_ranges[8][2] = {
 #error "Invalid PARAM_SET value. Must be 0, or 1."
 #endif
 
-#else
-#error "Invalid DIMENSIONS value. Must be 4, 6, or 8."
-#endif
-
-// Declare global arrays for data input
-float ownship_x[MAX_ENTRIES];
-float ownship_y[MAX_ENTRIES];
-float measure[MAX_ENTRIES];
-float timeframe[MAX_ENTRIES];
-// Global variables
-int data_size = 0;
-int numvars = 0;
-unsigned int random_state = 0; // globally assigned in main()
-
 // Random number generator (for simplicity, linear congruential generator)
-float random_float() {
+float random_float(unsigned int &random_state) {
     random_state = random_state * 1664525 + 1013904223;
     return (random_state % 1000) / 1000.0f; // Generate float in [0, 1)
 }
@@ -159,33 +99,32 @@ float random_float() {
 //     return dist(rng);
 // }
 
+void build_basis(const float timeframe[], int n, basis_table &basis) {
+    for (int i = 0; i < n; i++) {
+        float pow = 1.0f;
+        unsigned int fact = 1;
+        for (int k = 0; k < MAX_DIMENSIONS / 2; k++) {
+            basis.gamma[k][i] = pow / static_cast<float>(fact);
+            pow *= timeframe[i];
+            fact *= k + 1;
+        }
+    }
+}
+
 // Function to calculate the objective function
 float objective_function(const float theta[DIMENSIONS], const float ownship_x[],
                          const float ownship_y[], const float measure[],
-                         int n) {
+                         int n, const basis_table &basis) {
     float sum_squared_diff = 0.0f;
-    float timeframe = 0;
 
     for (int i = 0; i < n; i++) {
-
-        // Advance timeframe
-        timeframe += SAMPLING_TIME;
-
         // Compute target trajectory using a polynomial expansion vector theta
         float x_t = 0.0f;
         float y_t = 0.0f;
-        float pow = 1.0f;
-        unsigned int fact = 1;
-        int order = 1;
 
-        for (int j = 0; j < DIMENSIONS; j += 2) {
-            float gamma = pow/ static_cast<float>(fact);
-            x_t += theta[j] * gamma;
-            y_t += theta[j + 1] * gamma;
-
-            pow *= timeframe;
-            fact *= order;
-            order++;
+        for (int k = 0; k < DIMENSIONS / 2; k++) {
+            x_t += theta[2 * k] * basis.gamma[k][i];
+            y_t += theta[2 * k + 1] * basis.gamma[k][i];
         }
 
         // Calculate h (angle)
@@ -198,149 +137,343 @@ float objective_function(const float theta[DIMENSIONS], const float ownship_x[],
     return sum_squared_diff;
 }
 
-void aco(const float ownship_x[], const float ownship_y[],
-         const float measure[], float &best_fitness,
-         float best_solution[DIMENSIONS]) {
+void colony_init(colony_state &colony, unsigned int random_state,
+                 const float (*ranges)[2], pheromone_model model) {
+    if (!ranges)
+        ranges = parameter_ranges;
+    for (int d = 0; d < DIMENSIONS; d++) {
+        colony.ranges[d][0] = ranges[d][0];
+        colony.ranges[d][1] = ranges[d][1];
+        colony.pheromones[d] = 1.0f;
+    }
+    colony.random_state = random_state;
+    colony.best_fitness = numeric_limits<float>::max();
+    colony.prune = nullptr;
+    colony.model = model;
+    colony.archive_count = 0;
+}
 
-    // Initialise best solution
-    best_fitness = numeric_limits<float>::max();
+void colony_adopt(colony_state &colony, const float solution[DIMENSIONS],
+                  float fitness) {
+    if (fitness < colony.best_fitness) {
+        colony.best_fitness = fitness;
+        for (int i = 0; i < DIMENSIONS; i++) {
+            colony.best_solution[i] = solution[i];
+        }
+    }
 
-    // ACO algorithm
-    for (int iter = 0; iter < ITERATIONS; iter++) {
-        float ants[NUM_ANTS][DIMENSIONS]; // Ants' solutions
-        float fitness[NUM_ANTS];          // Fitness of each ant
+    if (colony.model != pheromone_model::archive)
+        return;
 
-        // Generate solutions and evaluate fitness
-        for (int ant = 0; ant < NUM_ANTS; ant++) {
-            for (int d = 0; d < DIMENSIONS; d++) {
-                // Generate a random value in the parameter range
-                float random_value = random_float();
-    		    float bias = pheromones[d];
-   		        float lower = parameter_ranges[d][0];
-    		    float upper = parameter_ranges[d][1];
+    // Insertion into the ranked archive, dropping the worst when full
+    int slot = colony.archive_count;
+    if (slot == ARCHIVE_SIZE) {
+        if (fitness >= colony.archive_fitness[ARCHIVE_SIZE - 1])
+            return;
+        slot--;
+    } else {
+        colony.archive_count++;
+    }
+    while (slot > 0 && colony.archive_fitness[slot - 1] > fitness) {
+        colony.archive_fitness[slot] = colony.archive_fitness[slot - 1];
+        for (int d = 0; d < DIMENSIONS; d++)
+            colony.archive[slot][d] = colony.archive[slot - 1][d];
+        slot--;
+    }
+    colony.archive_fitness[slot] = fitness;
+    for (int d = 0; d < DIMENSIONS; d++)
+        colony.archive[slot][d] = solution[d];
+}
 
-    		    // scale rand by pheromone
-   		        float biased_rand = powf(random_value, 1.0f / (1.0f + bias));
+// Vose alias table over the archive ranks, weight exp(-r^2 / (2 q^2 K^2)).
+// The weights depend only on rank, so one table serves every colony.
+struct alias_table {
+    float probability[ARCHIVE_SIZE];
+    int alias[ARCHIVE_SIZE];
+};
 
-                if (random_float() <= 0.2) biased_rand = random_value; // here epsilon=0.2
+static alias_table build_archive_alias() {
+    float scaled[ARCHIVE_SIZE];
+    float total = 0.0f;
+    for (int r = 0; r < ARCHIVE_SIZE; r++) {
+        float width = ARCHIVE_LOCALITY * ARCHIVE_SIZE;
+        scaled[r] = expf(-(r * r) / (2.0f * width * width));
+        total += scaled[r];
+    }
 
-   		        ants[ant][d] = lower + biased_rand * (upper - lower);
-            }
+    int small[ARCHIVE_SIZE], large[ARCHIVE_SIZE];
+    int num_small = 0, num_large = 0;
+    for (int r = 0; r < ARCHIVE_SIZE; r++) {
+        scaled[r] *= ARCHIVE_SIZE / total;
+        if (scaled[r] < 1.0f)
+            small[num_small++] = r;
+        else
+            large[num_large++] = r;
+    }
 
-            // Evaluate fitness
-            fitness[ant] = objective_function(ants[ant], ownship_x, ownship_y,
-                                              measure, MAX_ENTRIES);
+    alias_table table;
+    while (num_small > 0 && num_large > 0) {
+        int s = small[--num_small];
+        int l = large[--num_large];
+        table.probability[s] = scaled[s];
+        table.alias[s] = l;
+        scaled[l] -= 1.0f - scaled[s];
+        if (scaled[l] < 1.0f)
+            small[num_small++] = l;
+        else
+            large[num_large++] = l;
+    }
+    // Leftovers are 1 up to rounding
+    while (num_large > 0) {
+        int l = large[--num_large];
+        table.probability[l] = 1.0f;
+        table.alias[l] = l;
+    }
+    while (num_small > 0) {
+        int s = small[--num_small];
+        table.probability[s] = 1.0f;
+        table.alias[s] = s;
+    }
+    return table;
+}
 
-            // Update best solution if needed
-            if (fitness[ant] < best_fitness) {
-                best_fitness = fitness[ant];
-                for (int i = 0; i < DIMENSIONS; i++) {
-                    best_solution[i] = ants[ant][i];
-                }
+static int archive_guide(unsigned int &random_state) {
+    static const alias_table table = build_archive_alias();
+    int rank = static_cast<int>(random_float(random_state) * ARCHIVE_SIZE);
+    return random_float(random_state) < table.probability[rank]
+               ? rank
+               : table.alias[rank];
+}
+
+// Standard normal sample (Box-Muller)
+static float gaussian(unsigned int &random_state) {
+    float u1 = 1.0f - random_float(random_state); // (0, 1]
+    float u2 = random_float(random_state);
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.28318531f * u2);
+}
+
+void colony_seed(colony_state &colony, const float solution[DIMENSIONS],
+                 const objective_callback &objective) {
+    colony_adopt(colony, solution, objective(solution));
+}
+
+void colony_seed(colony_state &colony, const float solution[DIMENSIONS],
+                 const float ownship_x[], const float ownship_y[],
+                 const float measure[], const basis_table &basis, int n) {
+    colony_seed(colony, solution, [&](const float theta[DIMENSIONS]) {
+        return objective_function(theta, ownship_x, ownship_y, measure, n,
+                                  basis);
+    });
+}
+
+// One iteration of the archive model
+static bool archive_iterate(colony_state &colony,
+                            const objective_callback &objective) {
+    float ants[NUM_ANTS][DIMENSIONS];
+    float fitness[NUM_ANTS];
+    bool improved = false;
+    bool full = colony.archive_count == ARCHIVE_SIZE;
+
+    for (int ant = 0; ant < NUM_ANTS; ant++) {
+        if (!full) {
+            // Uniform, from a surviving cell if pruning is on
+            const float(*ranges)[2] = colony.ranges;
+            if (colony.prune)
+                ranges = prune_sample(*colony.prune,
+                                      random_float(colony.random_state))
+                             .ranges;
+            for (int d = 0; d < DIMENSIONS; d++) {
+                ants[ant][d] =
+                    ranges[d][0] + random_float(colony.random_state) *
+                                       (ranges[d][1] - ranges[d][0]);
             }
-        }
+        } else {
+            for (int attempt = 0;; attempt++) {
+                int guide = archive_guide(colony.random_state);
+                for (int d = 0; d < DIMENSIONS; d++) {
+                    float centre = colony.archive[guide][d];
+                    float spread = 0.0f;
+                    for (int e = 0; e < ARCHIVE_SIZE; e++)
+                        spread += fabsf(colony.archive[e][d] - centre);
+                    float sigma = ARCHIVE_SPREAD * spread / (ARCHIVE_SIZE - 1);
+
+                    float value = centre + sigma * gaussian(colony.random_state);
+                    ants[ant][d] = fminf(fmaxf(value, colony.ranges[d][0]),
+                                         colony.ranges[d][1]);
+                }
 
-        // Update pheromones
-        for (int d = 0; d < DIMENSIONS; d++) {
-            pheromones[d] *= (1.0f - EVAPORATION_RATE); // Evaporation
-            for (int ant = 0; ant < NUM_ANTS; ant++) {
-                pheromones[d] +=
-                    1.0f / (1.0f + fitness[ant]); // Deposit pheromones
+                if (!colony.prune || attempt >= ARCHIVE_PRUNE_RETRIES ||
+                    prune_contains(*colony.prune, ants[ant]))
+                    break;
             }
         }
 
-        DEBUG_PRINT("Iteration " << iter + 1 << "/" << ITERATIONS
-                                 << ", Best Fitness: " << best_fitness);
+        fitness[ant] = objective(ants[ant]);
+        if (fitness[ant] < colony.best_fitness)
+            improved = true;
     }
+
+    for (int ant = 0; ant < NUM_ANTS; ant++)
+        colony_adopt(colony, ants[ant], fitness[ant]);
+
+    return improved;
 }
 
-void load_data(const char *file_path) {
-    ifstream file(file_path);
+bool colony_iterate(colony_state &colony, const objective_callback &objective) {
+    if (colony.model == pheromone_model::archive)
+        return archive_iterate(colony, objective);
 
-    if (!file || !file.is_open()) {
-        cerr << "Error: Unable to open input file: \n" << file_path;
-        return;
-    }
+    float ants[NUM_ANTS][DIMENSIONS]; // Ants' solutions
+    float fitness[NUM_ANTS];          // Fitness of each ant
+    bool improved = false;
 
-    string line;
-    if (getline(file, line)) {
-        cout << "Skipping header: " << line;
-    }
+    // Generate solutions and evaluate fitness
+    for (int ant = 0; ant < NUM_ANTS; ant++) {
+        const float(*ranges)[2] = colony.ranges;
+        if (colony.prune)
+            ranges = prune_sample(*colony.prune,
+                                  random_float(colony.random_state)).ranges;
 
-    int index = 0;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        char comma;
+        for (int d = 0; d < DIMENSIONS; d++) {
+            // Generate a random value in the parameter range
+            float random_value = random_float(colony.random_state);
+            float bias = colony.pheromones[d];
+            float lower = ranges[d][0];
+            float upper = ranges[d][1];
 
-        // Parse four floats from CSV line
-        ss >> timeframe[index] >> comma >> ownship_x[index] >> comma >>
-            ownship_y[index] >> comma >> measure[index];
+            // scale rand by pheromone
+            float biased_rand = powf(random_value, 1.0f / (1.0f + bias));
 
-        DEBUG_PRINT(index << ", " << "timeframe = " << timeframe[index] << ", "
-                          << "ownship_x = " << ownship_x[index] << ", "
-                          << "ownship_y = " << ownship_y[index] << ", "
-                          << "measure = " << measure[index]);
+            if (random_float(colony.random_state) <= 0.2) biased_rand = random_value; // here epsilon=0.2
 
-        index++;
-    }
+            ants[ant][d] = lower + biased_rand * (upper - lower);
+        }
 
-    data_size = index;
-    file.close();
-    cout << "\nData successfully loaded. Total entries: " << data_size << "\n";
-}
+        // Evaluate fitness
+        fitness[ant] = objective(ants[ant]);
 
-int main(int argc, char *argv[]) {
-    if (argc != 3) { // Expect exactly three arguments
-        cerr << "Usage: " << argv[0] << " <seed> <filename.csv>\n";
-        return 1;
+        // Update best solution if needed
+        if (fitness[ant] < colony.best_fitness) {
+            colony.best_fitness = fitness[ant];
+            improved = true;
+            for (int i = 0; i < DIMENSIONS; i++) {
+                colony.best_solution[i] = ants[ant][i];
+            }
+        }
     }
 
-    char *endptr;
-    long seed = strtol(argv[1], &endptr, 10);
-    if (*endptr != '\0') {
-        cerr << "Invalid integer: %s\n" << argv[1];
-        return 1;
+    // Update pheromones
+    for (int d = 0; d < DIMENSIONS; d++) {
+        colony.pheromones[d] *= (1.0f - EVAPORATION_RATE); // Evaporation
+        for (int ant = 0; ant < NUM_ANTS; ant++) {
+            colony.pheromones[d] +=
+                1.0f / (1.0f + fitness[ant]); // Deposit pheromones
+        }
     }
 
-    random_state = (int)seed;
+    return improved;
+}
 
-    size_t len = strlen(argv[2]);
-    if (len < 4 || strcmp(argv[2] + len - 4, ".csv") != 0) {
-        cerr << "Input file must end in .csv\n";
-        return 1;
-    }
+bool colony_iterate(colony_state &colony, const float ownship_x[],
+                    const float ownship_y[], const float measure[],
+                    const basis_table &basis, int n) {
+    return colony_iterate(colony, [&](const float theta[DIMENSIONS]) {
+        return objective_function(theta, ownship_x, ownship_y, measure, n,
+                                  basis);
+    });
+}
+
+bool budget_exhausted(chrono::steady_clock::time_point start,
+                      chrono::steady_clock::time_point &iteration_start,
+                      int iter, const aco_options &options) {
+    if (options.budget_seconds <= 0.0 || (iter == 0 && !options.warm_start))
+        return false;
+
+    auto now = chrono::steady_clock::now();
+    double elapsed = chrono::duration<double>(now - start).count();
+    double last_iteration =
+        chrono::duration<double>(now - iteration_start).count();
+    iteration_start = now;
+    return elapsed + (iter > 0 ? last_iteration : 0.0) >
+           options.budget_seconds;
+}
 
-    // Load data
-    load_data(argv[2]);
+// Shared loop of both aco() variants. boundary, if set, runs at the start of
+// every iteration.
+static int aco_run(const objective_callback &objective, float &best_fitness,
+                   float best_solution[DIMENSIONS], unsigned int &random_state,
+                   const aco_options &options,
+                   const function<void(colony_state &, int)> &boundary) {
 
-    // Ensure that data_size is valid
-    if (data_size <= 0) {
-        cerr << "No data loaded. Exiting..." << endl;
-        return 1;
-    }
+    auto start_time = chrono::steady_clock::now();
+    auto iteration_start = start_time;
+
+    // Colony state is per run, so concurrent runs do not share it
+    colony_state colony;
+    colony_init(colony, random_state, options.ranges, options.model);
+    if (options.warm_start)
+        colony_seed(colony, options.warm_start, objective);
 
-    // Allocate arrays for best_solution and best_fitness (outputs)
-    float best_solution[DIMENSIONS];
-    float best_fitness;
+    int iter = 0;
+    int last_improvement = 0;
 
-    // Start timing
-    auto start_time = chrono::high_resolution_clock::now();
+    // ACO algorithm
+    while (iter < options.iterations) {
+        if (budget_exhausted(start_time, iteration_start, iter, options))
+            break;
+
+        if (boundary)
+            boundary(colony, iter);
+
+        if (colony_iterate(colony, objective)) {
+            last_improvement = iter;
+            if (options.on_improvement)
+                options.on_improvement(iter + 1, colony.best_fitness,
+                                       colony.best_solution);
+        }
 
-    // Run ACO routine
-    cout << "Running ACO minimisation...\n";
-    aco(ownship_x, ownship_y, measure, best_fitness, best_solution);
+        iter++;
+        DEBUG_PRINT("Iteration " << iter << "/" << options.iterations
+                                 << ", Best Fitness: " << colony.best_fitness);
+
+        // Hand-off criteria
+        if (options.target_fitness > 0.0f &&
+            colony.best_fitness <= options.target_fitness)
+            break;
+        if (options.stall_iterations > 0 &&
+            iter - last_improvement > options.stall_iterations)
+            break;
+    }
 
-    // Print results
-    cout << "Best Solution: ";
+    best_fitness = colony.best_fitness;
     for (int i = 0; i < DIMENSIONS; i++) {
-        cout << best_solution[i] << " ";
+        best_solution[i] = colony.best_solution[i];
     }
-    cout << "\nBest Fitness: " << best_fitness << "\n";
+    random_state = colony.random_state;
 
-    // Stop timing
-    auto end_time = chrono::high_resolution_clock::now();
-    auto elapsed = chrono::duration<double>(end_time - start_time).count();
-    cout << "Elapsed Time: " << elapsed << " seconds" << endl;
+    return iter;
+}
+
+int aco(const float ownship_x[], const float ownship_y[],
+        const float measure[], const basis_table &basis, float &best_fitness,
+        float best_solution[DIMENSIONS], int n, unsigned int &random_state,
+        const aco_options &options) {
+    prune_set prune;
+    auto objective = [&](const float theta[DIMENSIONS]) {
+        return objective_function(theta, ownship_x, ownship_y, measure, n,
+                                  basis);
+    };
+    auto boundary = [&](colony_state &colony, int iter) {
+        colony_prune(colony, prune, iter, options.prune_cells, ownship_x,
+                     ownship_y, measure, basis, n);
+    };
+    return aco_run(objective, best_fitness, best_solution, random_state,
+                   options, boundary);
+}
 
-    return 0;
+int aco(const objective_callback &objective, float &best_fitness,
+        float best_solution[DIMENSIONS], unsigned int &random_state,
+        const aco_options &options) {
+    return aco_run(objective, best_fitness, best_solution, random_state,
+                   options, nullptr);
 }
@@ -1,6 +1,8 @@
 #ifndef ACO_H
 #define ACO_H
 
+#include <chrono>
+#include <functional>
 #include <iostream>
 
 #ifdef DEBUG
@@ -16,6 +18,8 @@
 #define DIMENSIONS 6 // Number of parameters
 #endif
 
+#define MAX_DIMENSIONS 8 // Highest supported model order
+
 #if DIMENSIONS != 4 && DIMENSIONS != 6 && DIMENSIONS != 8
 #error                                                                         \
     "Invalid DIMENSIONS value. DIMENSIONS must be defined as 4, 6, or 8 (e.g., -DDIMENSIONS=6)"
@@ -30,13 +34,133 @@
 #define EVAPORATION_RATE 0.1 // Pheromone evaporation rate
 #define MAX_ENTRIES 1801     // Adjust this as per your actual data size
 
-#ifndef SAMPLING_TIME // Sampling time
-#warning "No SAMPLING_TIME set (e.g. -DSAMPLING_TIME=2), defaulting to SAMPLING_TIME=2"
-#define SAMPLING_TIME 2 // RNG seed
-#endif
+#define ARCHIVE_SIZE 50          // Solutions kept by the archive model
+#define ARCHIVE_LOCALITY 0.1f    // q: rank weight width, share of ARCHIVE_SIZE
+#define ARCHIVE_SPREAD 0.85f     // xi: Gaussian width per unit archive spread
+#define ARCHIVE_PRUNE_RETRIES 4  // Redraws of a sample in a pruned cell
+
+float random_float(unsigned int &random_state);
+
+// Built-in search box of the selected PARAM_SET; DIMENSIONS uses the leading
+// rows
+extern const float parameter_ranges[MAX_DIMENSIONS][2];
+
+// Polynomial trajectory basis of one track, gamma[k][i] = t_i^k / k! from the
+// sample timestamps. One contiguous row per order (structure of arrays), so
+// the objective reads the basis instead of recomputing powers and factorials.
+// All MAX_DIMENSIONS / 2 orders are filled, whatever DIMENSIONS is.
+struct basis_table {
+    float gamma[MAX_DIMENSIONS / 2][MAX_ENTRIES];
+};
+
+void build_basis(const float timeframe[], int n, basis_table &basis);
+
+float objective_function(const float theta[DIMENSIONS], const float ownship_x[],
+                         const float ownship_y[], const float measure[],
+                         int n, const basis_table &basis);
+
+struct prune_set; // prune.h
+
+// How a colony remembers where good solutions lie
+//   scalar:  one pheromone per coefficient biasing uniform samples
+//   archive: ACO_R. The colony keeps its ARCHIVE_SIZE best solutions ranked
+//            by fitness. Each ant picks a guide with a Gaussian weight on its
+//            rank (alias table, O(1)) and samples every coefficient from a
+//            normal distribution around the guide, with a width set by the
+//            archive's spread in that coefficient. Until the archive is full
+//            the ants sample uniformly.
+enum class pheromone_model { scalar, archive };
+
+// State of one colony between iterations
+struct colony_state {
+    float ranges[DIMENSIONS][2]; // search box [lower, upper] per coefficient
+    float pheromones[DIMENSIONS];
+    unsigned int random_state;
+    float best_fitness;
+    float best_solution[DIMENSIONS];
+    const prune_set *prune; // surviving cells to sample, nullptr = whole box
+    pheromone_model model;
+    int archive_count; // archive entries in use, best first
+    float archive_fitness[ARCHIVE_SIZE];
+    float archive[ARCHIVE_SIZE][DIMENSIONS];
+};
+
+// Fitness of a candidate theta, for running the colony over another track
+// representation (e.g. compact.h) instead of objective_function()
+typedef std::function<float(const float theta[DIMENSIONS])> objective_callback;
+
+// ranges = nullptr searches the built-in PARAM_SET box
+void colony_init(colony_state &colony, unsigned int random_state,
+                 const float (*ranges)[2] = nullptr,
+                 pheromone_model model = pheromone_model::scalar);
+
+// Offer a scored solution: it becomes the incumbent if it is better and,
+// under the archive model, takes an archive slot if it ranks high enough
+void colony_adopt(colony_state &colony, const float solution[DIMENSIONS],
+                  float fitness);
+
+// Make solution the colony's incumbent if it beats the current best
+void colony_seed(colony_state &colony, const float solution[DIMENSIONS],
+                 const float ownship_x[], const float ownship_y[],
+                 const float measure[], const basis_table &basis, int n);
+void colony_seed(colony_state &colony, const float solution[DIMENSIONS],
+                 const objective_callback &objective);
+
+// One iteration of NUM_ANTS ants. Returns true if the colony's best improved.
+bool colony_iterate(colony_state &colony, const float ownship_x[],
+                    const float ownship_y[], const float measure[],
+                    const basis_table &basis, int n);
+bool colony_iterate(colony_state &colony, const objective_callback &objective);
+
+// Called by aco() after every iteration that improved the best solution
+typedef std::function<void(int iteration, float best_fitness,
+                           const float best_solution[DIMENSIONS])>
+    improvement_callback;
+
+// When the ACO phase ends (0 disables the stall, target and budget criteria)
+// and where it searches
+struct aco_options {
+    int iterations = ITERATIONS; // iteration budget
+    int stall_iterations = 0;    // stop after this many without improvement
+    float target_fitness = 0.0f; // stop once best fitness reaches this
+    const float (*ranges)[2] = nullptr; // search box, nullptr = PARAM_SET box
+    // Anytime mode: wall-clock budget in seconds, checked at iteration
+    // boundaries. An iteration is only started if the previous one's duration
+    // says it will finish in time.
+    double budget_seconds = 0.0;
+    improvement_callback on_improvement; // aco() only
+    // Incumbent solution[DIMENSIONS] to start from, e.g. the previous
+    // update's result. With a warm start the budget may end the run before
+    // the first iteration; without one at least one iteration always runs.
+    const float *warm_start = nullptr;
+    // Branch-and-bound pruning (prune.h): split the box into up to this many
+    // cells once there is an incumbent and sample only the cells whose lower
+    // bound can still beat it. 0 disables.
+    int prune_cells = 0;
+    pheromone_model model = pheromone_model::scalar;
+};
+
+// Anytime budget check at the start of iteration iter of a run that began at
+// start: one clock read per call, and true if the next iteration would
+// overrun (judged by the last one's duration). iteration_start is the
+// caller's per-loop mark; initialise it to start.
+bool budget_exhausted(std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point &iteration_start,
+                      int iter, const aco_options &options);
+
+// One ACO run over n samples. The run only touches its arguments, so
+// independent runs may execute concurrently. best_fitness/best_solution
+// receive the best-so-far result however the run ends. Returns the
+// iterations run.
+int aco(const float ownship_x[], const float ownship_y[],
+        const float measure[], const basis_table &basis, float &best_fitness,
+        float best_solution[DIMENSIONS], int n, unsigned int &random_state,
+        const aco_options &options = aco_options());
 
-void aco(const float ownship_x[], const float ownship_y[],
-         const float measure[], const float timeframe[], float &best_fitness,
-         float best_solution[DIMENSIONS], int n);
+// ACO run scored by objective. Pruning needs the basis table, so
+// options.prune_cells is ignored.
+int aco(const objective_callback &objective, float &best_fitness,
+        float best_solution[DIMENSIONS], unsigned int &random_state,
+        const aco_options &options = aco_options());
 
 #endif // ACO_H
@@ -0,0 +1,109 @@
+#include "compact.h"
+#include <cmath>
+
+using namespace std;
+
+#define COMPACT_MAX_COUNT 32767
+#define COMPACT_BEARING_SCALE (3.14159265f / COMPACT_MAX_COUNT)
+
+static inline int16_t compact_quantise(float value, float scale) {
+    long count = lrintf(value / scale);
+    if (count > COMPACT_MAX_COUNT)
+        count = COMPACT_MAX_COUNT;
+    if (count < -COMPACT_MAX_COUNT)
+        count = -COMPACT_MAX_COUNT;
+    return static_cast<int16_t>(count);
+}
+
+bool compact_encode(const float timeframe[], const float ownship_x[],
+                    const float ownship_y[], const float measure[], int n,
+                    compact_track &track) {
+    if (n < 1)
+        return false;
+
+    float step = n > 1 ? (timeframe[n - 1] - timeframe[0]) / (n - 1) : 0.0f;
+    for (int i = 1; i < n; i++) {
+        float expected = timeframe[0] + i * step;
+        if (fabsf(timeframe[i] - expected) > COMPACT_TIME_TOLERANCE * step)
+            return false;
+    }
+
+    float min_x = ownship_x[0], max_x = ownship_x[0];
+    float min_y = ownship_y[0], max_y = ownship_y[0];
+    for (int i = 1; i < n; i++) {
+        min_x = fminf(min_x, ownship_x[i]);
+        max_x = fmaxf(max_x, ownship_x[i]);
+        min_y = fminf(min_y, ownship_y[i]);
+        max_y = fmaxf(max_y, ownship_y[i]);
+    }
+    float half_extent = fmaxf(max_x - min_x, max_y - min_y) / 2.0f;
+
+    track.n = n;
+    track.origin_x = min_x + (max_x - min_x) / 2.0f;
+    track.origin_y = min_y + (max_y - min_y) / 2.0f;
+    track.position_scale =
+        half_extent > 0.0f ? half_extent / COMPACT_MAX_COUNT : 1.0f;
+    track.time_origin = timeframe[0];
+    track.time_step = step;
+
+    track.ownship_x.resize(n);
+    track.ownship_y.resize(n);
+    track.measure.resize(n);
+    for (int i = 0; i < n; i++) {
+        track.ownship_x[i] = compact_quantise(ownship_x[i] - track.origin_x,
+                                              track.position_scale);
+        track.ownship_y[i] = compact_quantise(ownship_y[i] - track.origin_y,
+                                              track.position_scale);
+        track.measure[i] = compact_quantise(measure[i], COMPACT_BEARING_SCALE);
+    }
+
+    return true;
+}
+
+void compact_decode(const compact_track &track, float timeframe[],
+                    float ownship_x[], float ownship_y[], float measure[]) {
+    for (int i = 0; i < track.n; i++) {
+        timeframe[i] = track.time_origin + i * track.time_step;
+        ownship_x[i] = track.origin_x + track.ownship_x[i] * track.position_scale;
+        ownship_y[i] = track.origin_y + track.ownship_y[i] * track.position_scale;
+        measure[i] = track.measure[i] * COMPACT_BEARING_SCALE;
+    }
+}
+
+float compact_objective(const float theta[DIMENSIONS],
+                        const compact_track &track) {
+    // Coefficients of t^k relative to the origin, highest order last
+    float coeff_x[DIMENSIONS / 2];
+    float coeff_y[DIMENSIONS / 2];
+    float fact = 1.0f;
+    for (int k = 0; k < DIMENSIONS / 2; k++) {
+        coeff_x[k] = theta[2 * k] / fact;
+        coeff_y[k] = theta[2 * k + 1] / fact;
+        fact *= k + 1;
+    }
+    coeff_x[0] -= track.origin_x;
+    coeff_y[0] -= track.origin_y;
+
+    const int16_t *ownship_x = track.ownship_x.data();
+    const int16_t *ownship_y = track.ownship_y.data();
+    const int16_t *measure = track.measure.data();
+    float scale = track.position_scale;
+    float sum_squared_diff = 0.0f;
+
+    for (int i = 0; i < track.n; i++) {
+        float t = track.time_origin + i * track.time_step;
+
+        float x_t = coeff_x[DIMENSIONS / 2 - 1];
+        float y_t = coeff_y[DIMENSIONS / 2 - 1];
+        for (int k = DIMENSIONS / 2 - 2; k >= 0; k--) {
+            x_t = x_t * t + coeff_x[k];
+            y_t = y_t * t + coeff_y[k];
+        }
+
+        float h = atan2f(y_t - ownship_y[i] * scale, x_t - ownship_x[i] * scale);
+        float diff = measure[i] * COMPACT_BEARING_SCALE - h;
+        sum_squared_diff += diff * diff;
+    }
+
+    return sum_squared_diff;
+}
@@ -0,0 +1,46 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "aco.h"
+#include <cstdint>
+#include <vector>
+
+#define COMPACT_TIME_TOLERANCE 1e-3f // Allowed deviation from uniform sampling,
+                                     // as a share of the sampling interval
+
+// Track packed into 6 bytes per sample, against 16 for the float columns
+// plus 16 for the basis table:
+//   ownship position: int16 offsets from a per-track origin (the centre of
+//                     the ownship's bounding box), position_scale metres each
+//   bearing:          int16 over [-pi, pi], pi / 32767 radians each
+//   time:             implicit, t_i = time_origin + i * time_step
+struct compact_track {
+    int n = 0;
+    float origin_x = 0.0f;
+    float origin_y = 0.0f;
+    float position_scale = 1.0f;
+    float time_origin = 0.0f;
+    float time_step = 0.0f;
+    std::vector<int16_t> ownship_x;
+    std::vector<int16_t> ownship_y;
+    std::vector<int16_t> measure;
+};
+
+// Pack a track. Returns false (track untouched) unless the timestamps are
+// uniform to within COMPACT_TIME_TOLERANCE.
+bool compact_encode(const float timeframe[], const float ownship_x[],
+                    const float ownship_y[], const float measure[], int n,
+                    compact_track &track);
+
+// Unpack into float columns of track.n entries
+void compact_decode(const compact_track &track, float timeframe[],
+                    float ownship_x[], float ownship_y[], float measure[]);
+
+// objective_function() on the packed track. Decoding is fused into the
+// sample loop: positions and bearings are widened in registers, and x_t/y_t
+// are evaluated by Horner's rule in t relative to the track origin, so no
+// basis table is read.
+float compact_objective(const float theta[DIMENSIONS],
+                        const compact_track &track);
+
+#endif // COMPACT_H
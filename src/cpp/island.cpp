@@ -0,0 +1,185 @@
+#include "island.h"
+#include "prune.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+#define ISLAND_SEED_STRIDE 0x9E3779B9u // Seed offset between colonies
+
+// Single-producer, single-consumer mailbox guarded by a sequence counter
+// (seqlock). The writer never waits; a reader that overlaps a write sees a
+// changed sequence number and drops the message until the next migration.
+struct mailbox {
+    atomic<unsigned int> sequence{0}; // odd while a write is in progress
+    atomic<float> fitness{0.0f};
+    atomic<float> solution[DIMENSIONS];
+    atomic<float> pheromones[DIMENSIONS];
+};
+
+struct migrant {
+    float fitness;
+    float solution[DIMENSIONS];
+    float pheromones[DIMENSIONS];
+};
+
+static void mailbox_post(mailbox &box, const colony_state &colony) {
+    unsigned int seq = box.sequence.load(memory_order_relaxed);
+    box.sequence.store(seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    box.fitness.store(colony.best_fitness, memory_order_relaxed);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        box.solution[d].store(colony.best_solution[d], memory_order_relaxed);
+        box.pheromones[d].store(colony.pheromones[d], memory_order_relaxed);
+    }
+
+    box.sequence.store(seq + 2, memory_order_release);
+}
+
+// Returns true if a complete message newer than last_seen was read
+static bool mailbox_take(mailbox &box, unsigned int &last_seen,
+                         migrant &message) {
+    unsigned int before = box.sequence.load(memory_order_acquire);
+    if ((before & 1) || before == last_seen)
+        return false;
+
+    message.fitness = box.fitness.load(memory_order_relaxed);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        message.solution[d] = box.solution[d].load(memory_order_relaxed);
+        message.pheromones[d] = box.pheromones[d].load(memory_order_relaxed);
+    }
+
+    atomic_thread_fence(memory_order_acquire);
+    if (box.sequence.load(memory_order_relaxed) != before)
+        return false; // torn read
+
+    last_seen = before;
+    return true;
+}
+
+// Adopt a better immigrant's elite (into the archive too, under the archive
+// model) and pull the pheromones halfway towards the immigrant's
+static void colony_accept(colony_state &colony, const migrant &message) {
+    if (message.fitness >= colony.best_fitness)
+        return;
+
+    colony_adopt(colony, message.solution, message.fitness);
+    for (int d = 0; d < DIMENSIONS; d++) {
+        colony.pheromones[d] =
+            0.5f * (colony.pheromones[d] + message.pheromones[d]);
+    }
+}
+
+int island_aco(const float ownship_x[], const float ownship_y[],
+               const float measure[], const basis_table &basis,
+               float &best_fitness, float best_solution[DIMENSIONS], int n,
+               unsigned int random_state, const island_options &islands,
+               const aco_options &options) {
+    int colonies = islands.colonies > 0 ? islands.colonies : 1;
+    int interval = islands.migration_interval;
+
+    vector<colony_state> state(colonies);
+    vector<int> iterations(colonies, 0);
+
+    // inbox[to * colonies + from]: one mailbox per directed link, so every
+    // mailbox has a single writer and a single reader
+    unique_ptr<mailbox[]> inbox(new mailbox[colonies * colonies]);
+
+    // The budget covers the whole island run, so all colonies share a start
+    auto start_time = chrono::steady_clock::now();
+
+    auto run_colony = [&](int c) {
+        colony_state &colony = state[c];
+        prune_set prune;
+        // Spread the colony seeds so runs with consecutive seeds do not
+        // share colonies
+        colony_init(colony, random_state + c * ISLAND_SEED_STRIDE,
+                    options.ranges, options.model);
+        if (options.warm_start)
+            colony_seed(colony, options.warm_start, ownship_x, ownship_y,
+                        measure, basis, n);
+
+        vector<unsigned int> last_seen(colonies, 0);
+        migrant message;
+        int iter = 0;
+        int last_improvement = 0;
+        auto iteration_start = start_time;
+
+        while (iter < options.iterations) {
+            if (budget_exhausted(start_time, iteration_start, iter, options))
+                break;
+
+            colony_prune(colony, prune, iter, options.prune_cells, ownship_x,
+                         ownship_y, measure, basis, n);
+
+            if (colony_iterate(colony, ownship_x, ownship_y, measure,
+                               basis, n))
+                last_improvement = iter;
+
+            iter++;
+
+            if (colonies > 1 && interval > 0 && iter % interval == 0) {
+                // Emigrate
+                if (islands.topology == island_topology::ring) {
+                    int to = (c + 1) % colonies;
+                    mailbox_post(inbox[to * colonies + c], colony);
+                } else {
+                    for (int to = 0; to < colonies; to++) {
+                        if (to != c)
+                            mailbox_post(inbox[to * colonies + c], colony);
+                    }
+                }
+
+                // Immigrate
+                for (int from = 0; from < colonies; from++) {
+                    if (from != c &&
+                        mailbox_take(inbox[c * colonies + from],
+                                     last_seen[from], message))
+                        colony_accept(colony, message);
+                }
+            }
+
+            DEBUG_PRINT("Colony " << c << ", Iteration " << iter << "/"
+                                  << options.iterations << ", Best Fitness: "
+                                  << colony.best_fitness);
+
+            // Hand-off criteria
+            if (options.target_fitness > 0.0f &&
+                colony.best_fitness <= options.target_fitness)
+                break;
+            if (options.stall_iterations > 0 &&
+                iter - last_improvement > options.stall_iterations)
+                break;
+        }
+
+        iterations[c] = iter;
+        colony.prune = nullptr; // prune is local to this thread
+    };
+
+    vector<thread> workers;
+    for (int c = 1; c < colonies; c++)
+        workers.emplace_back(run_colony, c);
+    run_colony(0);
+    for (thread &worker : workers)
+        worker.join();
+
+    int best = 0;
+    int max_iterations = 0;
+    for (int c = 0; c < colonies; c++) {
+        if (state[c].best_fitness < state[best].best_fitness)
+            best = c;
+        if (iterations[c] > max_iterations)
+            max_iterations = iterations[c];
+    }
+
+    best_fitness = state[best].best_fitness;
+    for (int i = 0; i < DIMENSIONS; i++) {
+        best_solution[i] = state[best].best_solution[i];
+    }
+
+    return max_iterations;
+}
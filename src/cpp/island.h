@@ -0,0 +1,33 @@
+#ifndef ISLAND_H
+#define ISLAND_H
+
+#include "aco.h"
+
+#define ISLAND_MIGRATION_INTERVAL 50 // Default iterations between migrations
+
+// Which colonies receive a colony's elite at each migration
+//   ring: colony c sends to colony (c + 1) % C
+//   all:  every colony sends to every other colony
+enum class island_topology { ring, all };
+
+struct island_options {
+    int colonies = 4;
+    int migration_interval = ISLAND_MIGRATION_INTERVAL;
+    island_topology topology = island_topology::ring;
+};
+
+// Island-model ACO: options.colonies colonies run on their own threads with
+// independent pheromones and RNG streams. Every migration_interval iterations
+// each colony posts its elite (best solution, fitness and pheromones) to its
+// neighbours' mailboxes and adopts any better immigrant. Colony 0 uses
+// random_state as its seed, so with one colony the result matches aco().
+// The aco_options stop criteria and warm start apply to each colony; the
+// budget runs from the call, and on_improvement is not called. Returns the
+// largest iteration count run by any colony.
+int island_aco(const float ownship_x[], const float ownship_y[],
+               const float measure[], const basis_table &basis,
+               float &best_fitness, float best_solution[DIMENSIONS], int n,
+               unsigned int random_state, const island_options &islands,
+               const aco_options &options = aco_options());
+
+#endif // ISLAND_H
@@ -0,0 +1,215 @@
+#include "lm.h"
+#include <cmath>
+
+using namespace std;
+
+// Residuals r_i = measure_i - atan2(y_t - y_o, x_t - x_o) and, if jtj is
+// given, the normal equations J^T J and J^T r with J = dr/dtheta. Returns
+// sum(r_i^2).
+static double lm_linearise(const double theta[DIMENSIONS],
+                           const float ownship_x[], const float ownship_y[],
+                           const float measure[], const basis_table &basis, int n,
+                           double jtj[DIMENSIONS][DIMENSIONS],
+                           double jtr[DIMENSIONS]) {
+    if (jtj) {
+        for (int a = 0; a < DIMENSIONS; a++) {
+            jtr[a] = 0.0;
+            for (int b = 0; b < DIMENSIONS; b++)
+                jtj[a][b] = 0.0;
+        }
+    }
+
+    double cost = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        double gamma[DIMENSIONS / 2];
+        for (int k = 0; k < DIMENSIONS / 2; k++)
+            gamma[k] = basis.gamma[k][i];
+
+        double x_t = 0.0, y_t = 0.0;
+        for (int k = 0; k < DIMENSIONS / 2; k++) {
+            x_t += theta[2 * k] * gamma[k];
+            y_t += theta[2 * k + 1] * gamma[k];
+        }
+
+        double dx = x_t - ownship_x[i];
+        double dy = y_t - ownship_y[i];
+        double r = measure[i] - atan2(dy, dx);
+        cost += r * r;
+
+        if (!jtj)
+            continue;
+
+        // d atan2(dy, dx) = (dx * d(dy) - dy * d(dx)) / rho^2
+        double rho2 = dx * dx + dy * dy;
+        if (rho2 == 0.0)
+            continue;
+
+        double row[DIMENSIONS];
+        for (int k = 0; k < DIMENSIONS / 2; k++) {
+            row[2 * k] = dy / rho2 * gamma[k];
+            row[2 * k + 1] = -dx / rho2 * gamma[k];
+        }
+        for (int a = 0; a < DIMENSIONS; a++) {
+            jtr[a] += row[a] * r;
+            for (int b = a; b < DIMENSIONS; b++)
+                jtj[a][b] += row[a] * row[b];
+        }
+    }
+
+    if (jtj) {
+        for (int a = 0; a < DIMENSIONS; a++)
+            for (int b = 0; b < a; b++)
+                jtj[a][b] = jtj[b][a];
+    }
+    return cost;
+}
+
+bool cholesky_solve(double a[DIMENSIONS][DIMENSIONS],
+                    const double b[DIMENSIONS], double x[DIMENSIONS]) {
+    double l[DIMENSIONS][DIMENSIONS] = {};
+    for (int i = 0; i < DIMENSIONS; i++) {
+        for (int j = 0; j <= i; j++) {
+            double sum = a[i][j];
+            for (int k = 0; k < j; k++)
+                sum -= l[i][k] * l[j][k];
+            if (i == j) {
+                if (!(sum > 0.0))
+                    return false;
+                l[i][i] = sqrt(sum);
+            } else {
+                l[i][j] = sum / l[j][j];
+            }
+        }
+    }
+
+    double y[DIMENSIONS];
+    for (int i = 0; i < DIMENSIONS; i++) {
+        double sum = b[i];
+        for (int k = 0; k < i; k++)
+            sum -= l[i][k] * y[k];
+        y[i] = sum / l[i][i];
+    }
+    for (int i = DIMENSIONS - 1; i >= 0; i--) {
+        double sum = y[i];
+        for (int k = i + 1; k < DIMENSIONS; k++)
+            sum -= l[k][i] * x[k];
+        x[i] = sum / l[i][i];
+    }
+    return true;
+}
+
+int lm_refine(const float ownship_x[], const float ownship_y[],
+              const float measure[], const basis_table &basis,
+              float theta[DIMENSIONS], float &fitness, int n,
+              int max_iterations) {
+    double current[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++)
+        current[d] = theta[d];
+
+    double jtj[DIMENSIONS][DIMENSIONS];
+    double jtr[DIMENSIONS];
+    double cost = lm_linearise(current, ownship_x, ownship_y, measure,
+                               basis, n, jtj, jtr);
+    double lambda = 1e-3;
+    int accepted = 0;
+
+    for (int iter = 0; iter < max_iterations && lambda < 1e12; iter++) {
+        // Marquardt damping scales with the diagonal, which copes with the
+        // very different magnitudes of position and higher-order terms
+        double damped[DIMENSIONS][DIMENSIONS];
+        double rhs[DIMENSIONS];
+        for (int a = 0; a < DIMENSIONS; a++) {
+            for (int b = 0; b < DIMENSIONS; b++)
+                damped[a][b] = jtj[a][b];
+            damped[a][a] += lambda * (jtj[a][a] > 0.0 ? jtj[a][a] : 1.0);
+            rhs[a] = -jtr[a];
+        }
+
+        double step[DIMENSIONS];
+        if (!cholesky_solve(damped, rhs, step)) {
+            lambda *= 10.0;
+            continue;
+        }
+
+        double candidate[DIMENSIONS];
+        for (int d = 0; d < DIMENSIONS; d++)
+            candidate[d] = current[d] + step[d];
+
+        double candidate_cost = lm_linearise(candidate, ownship_x, ownship_y,
+                                             measure, basis, n,
+                                             nullptr, nullptr);
+        if (candidate_cost < cost) {
+            double improvement = (cost - candidate_cost) / cost;
+            for (int d = 0; d < DIMENSIONS; d++)
+                current[d] = candidate[d];
+            cost = lm_linearise(current, ownship_x, ownship_y, measure,
+                                basis, n, jtj, jtr);
+            lambda = (lambda > 1e-12) ? lambda * 0.1 : lambda;
+            accepted++;
+
+            DEBUG_PRINT("LM step " << accepted << ", cost: " << cost
+                                   << ", lambda: " << lambda);
+            if (improvement < 1e-9)
+                break;
+        } else {
+            lambda *= 10.0;
+        }
+    }
+
+    // Keep the refined solution only if it also wins in single precision
+    float refined[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++)
+        refined[d] = static_cast<float>(current[d]);
+    float refined_fitness = objective_function(refined, ownship_x, ownship_y,
+                                               measure, n, basis);
+    if (refined_fitness < fitness) {
+        fitness = refined_fitness;
+        for (int d = 0; d < DIMENSIONS; d++)
+            theta[d] = refined[d];
+    }
+
+    return accepted;
+}
+
+bool lm_sigma(const float ownship_x[], const float ownship_y[],
+              const float measure[], const basis_table &basis,
+              const float theta[DIMENSIONS], int n, float sigma[DIMENSIONS]) {
+    if (n <= DIMENSIONS)
+        return false;
+
+    double current[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++)
+        current[d] = theta[d];
+
+    double jtj[DIMENSIONS][DIMENSIONS];
+    double jtr[DIMENSIONS];
+    double cost = lm_linearise(current, ownship_x, ownship_y, measure,
+                               basis, n, jtj, jtr);
+    double variance = cost / (n - DIMENSIONS);
+
+    // Invert the correlation matrix D^-1/2 J^T J D^-1/2 rather than J^T J
+    // itself, whose diagonal spans many orders of magnitude
+    double scale[DIMENSIONS];
+    for (int a = 0; a < DIMENSIONS; a++) {
+        if (!(jtj[a][a] > 0.0))
+            return false;
+        scale[a] = 1.0 / sqrt(jtj[a][a]);
+    }
+    for (int a = 0; a < DIMENSIONS; a++)
+        for (int b = 0; b < DIMENSIONS; b++)
+            jtj[a][b] *= scale[a] * scale[b];
+
+    double deviation[DIMENSIONS];
+    for (int a = 0; a < DIMENSIONS; a++) {
+        double unit[DIMENSIONS] = {};
+        double column[DIMENSIONS];
+        unit[a] = 1.0;
+        if (!cholesky_solve(jtj, unit, column))
+            return false;
+        deviation[a] = sqrt(variance * column[a]) * scale[a];
+    }
+    for (int a = 0; a < DIMENSIONS; a++)
+        sigma[a] = static_cast<float>(deviation[a]);
+    return true;
+}
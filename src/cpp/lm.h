@@ -0,0 +1,28 @@
+#ifndef LM_H
+#define LM_H
+
+#include "aco.h"
+
+#define LM_MAX_ITERATIONS 50 // Default Levenberg-Marquardt iteration budget
+
+// Solve A x = b for symmetric positive definite A by Cholesky. Returns false
+// if A is not positive definite.
+bool cholesky_solve(double a[DIMENSIONS][DIMENSIONS],
+                    const double b[DIMENSIONS], double x[DIMENSIONS]);
+
+// Levenberg-Marquardt polish of an ACO solution. theta and fitness are
+// updated in place only if the refined solution scores better under
+// objective_function(). Returns the number of accepted steps.
+int lm_refine(const float ownship_x[], const float ownship_y[],
+              const float measure[], const basis_table &basis,
+              float theta[DIMENSIONS], float &fitness, int n,
+              int max_iterations = LM_MAX_ITERATIONS);
+
+// Standard deviation of each coefficient of theta from the Gauss-Newton
+// covariance s^2 (J^T J)^-1, with s^2 = sum(r_i^2) / (n - DIMENSIONS).
+// Returns false if J^T J is singular.
+bool lm_sigma(const float ownship_x[], const float ownship_y[],
+              const float measure[], const basis_table &basis,
+              const float theta[DIMENSIONS], int n, float sigma[DIMENSIONS]);
+
+#endif // LM_H
@@ -0,0 +1,391 @@
+#include "aco.h"
+#include "compact.h"
+#include "island.h"
+#include "lm.h"
+#include "nested.h"
+#include "ple.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+// Declare global arrays for data input
+float ownship_x[MAX_ENTRIES];
+float ownship_y[MAX_ENTRIES];
+float measure[MAX_ENTRIES];
+float timeframe[MAX_ENTRIES];
+basis_table basis; // built from timeframe[] once per track
+// Global variables
+int data_size = 0;
+unsigned int random_state = 0; // globally assigned in main()
+
+void load_data(const char *file_path) {
+    ifstream file(file_path);
+
+    if (!file || !file.is_open()) {
+        cerr << "Error: Unable to open input file: \n" << file_path;
+        return;
+    }
+
+    string line;
+    if (getline(file, line)) {
+        cout << "Skipping header: " << line;
+    }
+
+    int index = 0;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        char comma;
+
+        // Parse four floats from CSV line
+        ss >> timeframe[index] >> comma >> ownship_x[index] >> comma >>
+            ownship_y[index] >> comma >> measure[index];
+
+        DEBUG_PRINT(index << ", " << "timeframe = " << timeframe[index] << ", "
+                          << "ownship_x = " << ownship_x[index] << ", "
+                          << "ownship_y = " << ownship_y[index] << ", "
+                          << "measure = " << measure[index]);
+
+        index++;
+    }
+
+    data_size = index;
+    file.close();
+    cout << "\nData successfully loaded. Total entries: " << data_size << "\n";
+}
+
+void print_usage(const char *program) {
+    cerr << "Usage: " << program << " <seed> <filename.csv> [options]\n"
+         << "  --iterations N     ACO iteration budget (default "
+         << ITERATIONS << ")\n"
+         << "  --stall N          end ACO after N iterations without "
+            "improvement\n"
+         << "  --target F         end ACO once best fitness <= F\n"
+         << "  --budget S         end ACO within S seconds of wall-clock "
+            "time\n"
+         << "  --progress         print every improvement of the best "
+            "fitness\n"
+         << "  --lm               polish the ACO result with "
+            "Levenberg-Marquardt\n"
+         << "  --lm-iterations N  LM iteration budget (default "
+         << LM_MAX_ITERATIONS << ")\n"
+         << "  --ple              derive the search box from a pseudo-linear "
+            "estimate\n"
+         << "  --model M          pheromone model: scalar (default) or "
+            "archive\n"
+         << "  --prune N          sample only the branch-and-bound cells "
+            "(up to N) that can beat the best\n"
+         << "  --islands C        run C colonies in parallel\n"
+         << "  --migration N      iterations between elite exchanges "
+            "(default "
+         << ISLAND_MIGRATION_INTERVAL << ")\n"
+         << "  --topology T       migration topology: ring (default) or "
+            "all\n"
+         << "  --nested           fit orders 4, 6 and 8 jointly and select "
+            "by BIC\n"
+         << "  --compact          run ACO on the 16-bit compact track and "
+            "report its accuracy\n";
+}
+
+// Encoding error and evaluation throughput of the compact track against the
+// float columns
+void report_compact(const compact_track &track) {
+    float decoded_t[MAX_ENTRIES], decoded_x[MAX_ENTRIES];
+    float decoded_y[MAX_ENTRIES], decoded_m[MAX_ENTRIES];
+    compact_decode(track, decoded_t, decoded_x, decoded_y, decoded_m);
+
+    float position_error = 0.0f, bearing_error = 0.0f;
+    for (int i = 0; i < data_size; i++) {
+        position_error = max(position_error,
+                             max(fabsf(decoded_x[i] - ownship_x[i]),
+                                 fabsf(decoded_y[i] - ownship_y[i])));
+        bearing_error = max(bearing_error, fabsf(decoded_m[i] - measure[i]));
+    }
+
+    size_t compact_bytes = 3 * sizeof(int16_t);
+    size_t float_bytes = 4 * sizeof(float) + sizeof(basis.gamma) /
+                                                 MAX_ENTRIES;
+    cout << "Compact track: " << compact_bytes << " bytes/sample (float "
+         << "columns and basis table: " << float_bytes << ")\n";
+    cout << "Max Position Error: " << position_error << " m\n";
+    cout << "Max Bearing Error: " << bearing_error << " rad\n";
+
+    // Score the same points both ways
+    const int evaluations = 2000;
+    unsigned int state = random_state;
+    float theta[DIMENSIONS];
+    float fitness_error = 0.0f, fitness_scale = 0.0f;
+    double float_seconds = 0.0, compact_seconds = 0.0;
+    for (int e = 0; e < evaluations; e++) {
+        for (int d = 0; d < DIMENSIONS; d++)
+            theta[d] = parameter_ranges[d][0] +
+                       random_float(state) *
+                           (parameter_ranges[d][1] - parameter_ranges[d][0]);
+
+        auto t0 = chrono::steady_clock::now();
+        float full = objective_function(theta, ownship_x, ownship_y, measure,
+                                        data_size, basis);
+        auto t1 = chrono::steady_clock::now();
+        float packed = compact_objective(theta, track);
+        auto t2 = chrono::steady_clock::now();
+
+        float_seconds += chrono::duration<double>(t1 - t0).count();
+        compact_seconds += chrono::duration<double>(t2 - t1).count();
+        fitness_error = max(fitness_error, fabsf(packed - full));
+        fitness_scale = max(fitness_scale, fabsf(full));
+    }
+    cout << "Max Fitness Error: " << fitness_error << " (over "
+         << evaluations << " random points, largest fitness "
+         << fitness_scale << ")\n";
+    cout << "Evaluations/s (float/compact): " << evaluations / float_seconds
+         << " / " << evaluations / compact_seconds << "\n";
+}
+
+// Joint order-4/6/8 solve; reports every order and the BIC choice
+void run_nested(const aco_options &options) {
+    nested_result results[NESTED_ORDERS];
+
+    auto start_time = chrono::high_resolution_clock::now();
+
+    cout << "Running nested ACO minimisation (orders 4, 6, 8)...\n";
+    int iterations = nested_aco(ownship_x, ownship_y, measure, basis,
+                                data_size, random_state, results, options);
+    int selected = nested_select(results);
+
+    cout << "ACO Iterations: " << iterations << "\n";
+    for (int o = 0; o < NESTED_ORDERS; o++) {
+        cout << "Order " << results[o].dimensions
+             << ": Fitness: " << results[o].best_fitness
+             << ", AIC: " << results[o].aic << ", BIC: " << results[o].bic
+             << ", Solution: ";
+        for (int i = 0; i < results[o].dimensions; i++) {
+            cout << results[o].best_solution[i] << " ";
+        }
+        cout << "\n";
+    }
+
+    // Print results
+    cout << "Selected Order: " << results[selected].dimensions << "\n";
+    cout << "Best Solution: ";
+    for (int i = 0; i < results[selected].dimensions; i++) {
+        cout << results[selected].best_solution[i] << " ";
+    }
+    cout << "\nBest Fitness: " << results[selected].best_fitness << "\n";
+
+    auto end_time = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration<double>(end_time - start_time).count();
+    cout << "Elapsed Time: " << elapsed << " seconds" << endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) { // Expect at least three arguments
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    aco_options options;
+    bool refine = false;
+    int lm_iterations = LM_MAX_ITERATIONS;
+    bool nested = false;
+    bool derive_ranges = false;
+    bool compact = false;
+    float ranges[DIMENSIONS][2];
+    island_options islands;
+    islands.colonies = 1;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--lm") == 0) {
+            refine = true;
+        } else if (strcmp(argv[i], "--nested") == 0) {
+            nested = true;
+        } else if (strcmp(argv[i], "--ple") == 0) {
+            derive_ranges = true;
+        } else if (strcmp(argv[i], "--compact") == 0) {
+            compact = true;
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            options.iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stall") == 0 && i + 1 < argc) {
+            options.stall_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            options.target_fitness = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            options.budget_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--progress") == 0) {
+            options.on_improvement = [](int iteration, float fitness,
+                                        const float[DIMENSIONS]) {
+                cout << "  Iteration " << iteration << ": " << fitness << "\n";
+            };
+        } else if (strcmp(argv[i], "--lm-iterations") == 0 && i + 1 < argc) {
+            lm_iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--prune") == 0 && i + 1 < argc) {
+            options.prune_cells = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--islands") == 0 && i + 1 < argc) {
+            islands.colonies = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--migration") == 0 && i + 1 < argc) {
+            islands.migration_interval = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--model") == 0 && i + 1 < argc) {
+            const char *model = argv[++i];
+            if (strcmp(model, "scalar") == 0) {
+                options.model = pheromone_model::scalar;
+            } else if (strcmp(model, "archive") == 0) {
+                options.model = pheromone_model::archive;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--topology") == 0 && i + 1 < argc) {
+            const char *topology = argv[++i];
+            if (strcmp(topology, "ring") == 0) {
+                islands.topology = island_topology::ring;
+            } else if (strcmp(topology, "all") == 0) {
+                islands.topology = island_topology::all;
+            } else {
+                print_usage(argv[0]);
+                return 1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (nested && (refine || derive_ranges || islands.colonies > 1 ||
+                   options.budget_seconds > 0.0 || options.on_improvement ||
+                   options.prune_cells > 0 ||
+                   options.model != pheromone_model::scalar)) {
+        cerr << "--nested cannot be combined with --lm, --ple, --islands, "
+                "--budget, --progress, --prune or --model\n";
+        return 1;
+    }
+
+    if (islands.colonies > 1 && options.on_improvement) {
+        cerr << "--progress cannot be combined with --islands\n";
+        return 1;
+    }
+
+    if (compact && (nested || islands.colonies > 1 || options.prune_cells > 0)) {
+        cerr << "--compact cannot be combined with --nested, --islands or "
+                "--prune\n";
+        return 1;
+    }
+
+    char *endptr;
+    long seed = strtol(argv[1], &endptr, 10);
+    if (*endptr != '\0') {
+        cerr << "Invalid integer: %s\n" << argv[1];
+        return 1;
+    }
+
+    random_state = (int)seed;
+
+    size_t len = strlen(argv[2]);
+    if (len < 4 || strcmp(argv[2] + len - 4, ".csv") != 0) {
+        cerr << "Input file must end in .csv\n";
+        return 1;
+    }
+
+    // Load data
+    load_data(argv[2]);
+
+    // Ensure that data_size is valid
+    if (data_size <= 0) {
+        cerr << "No data loaded. Exiting..." << endl;
+        return 1;
+    }
+
+    build_basis(timeframe, data_size, basis);
+
+    compact_track track;
+    if (compact) {
+        if (!compact_encode(timeframe, ownship_x, ownship_y, measure,
+                            data_size, track)) {
+            cerr << "--compact needs uniformly sampled timestamps\n";
+            return 1;
+        }
+        report_compact(track);
+    }
+
+    if (nested) {
+        run_nested(options);
+        return 0;
+    }
+
+    // Allocate arrays for best_solution and best_fitness (outputs)
+    float best_solution[DIMENSIONS];
+    float best_fitness;
+
+    // Start timing
+    auto start_time = chrono::high_resolution_clock::now();
+
+    // Run ACO routine
+    if (derive_ranges) {
+        cout << "Deriving search box from pseudo-linear estimate...\n";
+        if (ple_search_box(ownship_x, ownship_y, measure, basis,
+                           data_size, ranges)) {
+            options.ranges = ranges;
+            for (int d = 0; d < DIMENSIONS; d++) {
+                cout << "  theta[" << d << "]: [" << ranges[d][0] << ", "
+                     << ranges[d][1] << "]\n";
+            }
+        } else {
+            cout << "Pseudo-linear estimate failed, using PARAM_SET box\n";
+        }
+    }
+
+    int iterations;
+    if (islands.colonies > 1) {
+        cout << "Running island ACO minimisation (" << islands.colonies
+             << " colonies)...\n";
+        iterations = island_aco(ownship_x, ownship_y, measure, basis,
+                                best_fitness, best_solution, data_size,
+                                random_state, islands, options);
+    } else if (compact) {
+        cout << "Running ACO minimisation on the compact track...\n";
+        iterations = aco(
+            [&](const float theta[DIMENSIONS]) {
+                return compact_objective(theta, track);
+            },
+            best_fitness, best_solution, random_state, options);
+
+        // Report the fit against the full-precision track
+        cout << "Compact Fitness: " << best_fitness << "\n";
+        best_fitness = objective_function(best_solution, ownship_x, ownship_y,
+                                          measure, data_size, basis);
+    } else {
+        cout << "Running ACO minimisation...\n";
+        iterations = aco(ownship_x, ownship_y, measure, basis,
+                         best_fitness, best_solution, data_size, random_state,
+                         options);
+    }
+
+    if (refine || options.budget_seconds > 0.0)
+        cout << "ACO Iterations: " << iterations << "\n";
+
+    if (refine) {
+        cout << "ACO Fitness: " << best_fitness << "\n";
+        cout << "Running Levenberg-Marquardt refinement...\n";
+        int steps = lm_refine(ownship_x, ownship_y, measure, basis,
+                              best_solution, best_fitness, data_size,
+                              lm_iterations);
+        cout << "LM Steps: " << steps << "\n";
+    }
+
+    // Print results
+    cout << "Best Solution: ";
+    for (int i = 0; i < DIMENSIONS; i++) {
+        cout << best_solution[i] << " ";
+    }
+    cout << "\nBest Fitness: " << best_fitness << "\n";
+
+    // Stop timing
+    auto end_time = chrono::high_resolution_clock::now();
+    auto elapsed = chrono::duration<double>(end_time - start_time).count();
+    cout << "Elapsed Time: " << elapsed << " seconds" << endl;
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "nested.h"
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// Pheromone block (and model order index) that introduces coefficient d
+static inline int nested_block(int d) { return d < 4 ? 0 : d / 2 - 1; }
+
+// Residual sum of squares of the order-4, -6 and -8 prefixes of theta in one
+// pass over the samples
+static void nested_objective(const float theta[MAX_DIMENSIONS],
+                             const float ownship_x[], const float ownship_y[],
+                             const float measure[], const basis_table &basis,
+                             int n, float fitness[NESTED_ORDERS]) {
+    float sum_squared_diff[NESTED_ORDERS] = {};
+
+    for (int i = 0; i < n; i++) {
+        // Order 4: constant velocity
+        float x_t = theta[0] + theta[2] * basis.gamma[1][i];
+        float y_t = theta[1] + theta[3] * basis.gamma[1][i];
+
+        for (int o = 0; o < NESTED_ORDERS; o++) {
+            if (o > 0) {
+                x_t += theta[2 * o + 2] * basis.gamma[o + 1][i];
+                y_t += theta[2 * o + 3] * basis.gamma[o + 1][i];
+            }
+
+            float h = atan2f(y_t - ownship_y[i], x_t - ownship_x[i]);
+            sum_squared_diff[o] += (measure[i] - h) * (measure[i] - h);
+        }
+    }
+
+    for (int o = 0; o < NESTED_ORDERS; o++)
+        fitness[o] = sum_squared_diff[o];
+}
+
+int nested_aco(const float ownship_x[], const float ownship_y[],
+               const float measure[], const basis_table &basis, int n,
+               unsigned int &random_state,
+               nested_result results[NESTED_ORDERS],
+               const aco_options &options) {
+    float pheromones[NESTED_ORDERS];
+    float ants[NUM_ANTS][MAX_DIMENSIONS];
+    float fitness[NUM_ANTS][NESTED_ORDERS];
+
+    for (int o = 0; o < NESTED_ORDERS; o++) {
+        pheromones[o] = 1.0f;
+        results[o].dimensions = 4 + 2 * o;
+        results[o].best_fitness = numeric_limits<float>::max();
+    }
+
+    int iter = 0;
+    int last_improvement = 0;
+
+    while (iter < options.iterations) {
+        for (int ant = 0; ant < NUM_ANTS; ant++) {
+            for (int d = 0; d < MAX_DIMENSIONS; d++) {
+                // Same epsilon-greedy sampling as colony_iterate()
+                float random_value = random_float(random_state);
+                float bias = pheromones[nested_block(d)];
+                float lower = parameter_ranges[d][0];
+                float upper = parameter_ranges[d][1];
+
+                float biased_rand = powf(random_value, 1.0f / (1.0f + bias));
+
+                if (random_float(random_state) <= 0.2) biased_rand = random_value;
+
+                ants[ant][d] = lower + biased_rand * (upper - lower);
+            }
+
+            nested_objective(ants[ant], ownship_x, ownship_y, measure, basis,
+                             n, fitness[ant]);
+
+            for (int o = 0; o < NESTED_ORDERS; o++) {
+                if (fitness[ant][o] < results[o].best_fitness) {
+                    results[o].best_fitness = fitness[ant][o];
+                    last_improvement = iter;
+                    for (int d = 0; d < MAX_DIMENSIONS; d++) {
+                        results[o].best_solution[d] =
+                            d < results[o].dimensions ? ants[ant][d] : 0.0f;
+                    }
+                }
+            }
+        }
+
+        // The models are nested: a lower order's best, padded with zeros, is
+        // a candidate for every higher order and scores the same there.
+        // Without this the sampled higher-order coefficients are never
+        // exactly zero, and a higher order can report a worse fit than the
+        // order below it.
+        for (int o = 1; o < NESTED_ORDERS; o++) {
+            if (results[o - 1].best_fitness < results[o].best_fitness) {
+                results[o].best_fitness = results[o - 1].best_fitness;
+                for (int d = 0; d < MAX_DIMENSIONS; d++)
+                    results[o].best_solution[d] =
+                        results[o - 1].best_solution[d];
+            }
+        }
+
+        // Update pheromones, one block per order
+        for (int o = 0; o < NESTED_ORDERS; o++) {
+            pheromones[o] *= (1.0f - EVAPORATION_RATE); // Evaporation
+            for (int ant = 0; ant < NUM_ANTS; ant++) {
+                pheromones[o] += 1.0f / (1.0f + fitness[ant][o]); // Deposit
+            }
+        }
+
+        iter++;
+        DEBUG_PRINT("Iteration " << iter << "/" << options.iterations
+                                 << ", Best Fitness (4/6/8): "
+                                 << results[0].best_fitness << " "
+                                 << results[1].best_fitness << " "
+                                 << results[2].best_fitness);
+
+        // Hand-off criteria
+        bool reached = options.target_fitness > 0.0f;
+        for (int o = 0; o < NESTED_ORDERS; o++) {
+            if (results[o].best_fitness > options.target_fitness)
+                reached = false;
+        }
+        if (reached)
+            break;
+        if (options.stall_iterations > 0 &&
+            iter - last_improvement > options.stall_iterations)
+            break;
+    }
+
+    // Information criteria for Gaussian residuals
+    for (int o = 0; o < NESTED_ORDERS; o++) {
+        double rss = results[o].best_fitness > 0.0f
+                         ? results[o].best_fitness
+                         : numeric_limits<float>::min();
+        double fit = n * log(rss / n);
+        results[o].aic = fit + 2.0 * results[o].dimensions;
+        results[o].bic = fit + results[o].dimensions * log(double(n));
+    }
+
+    return iter;
+}
+
+int nested_select(const nested_result results[NESTED_ORDERS]) {
+    int best = 0;
+    for (int o = 1; o < NESTED_ORDERS; o++) {
+        if (results[o].bic < results[best].bic)
+            best = o;
+    }
+    return best;
+}
@@ -0,0 +1,36 @@
+#ifndef NESTED_H
+#define NESTED_H
+
+#include "aco.h"
+
+#define NESTED_ORDERS 3 // Models of 4, 6 and 8 parameters
+
+// Best fit of one model order from a nested run
+struct nested_result {
+    int dimensions;                       // 4, 6 or 8
+    float best_fitness;                   // residual sum of squares
+    float best_solution[MAX_DIMENSIONS];  // leading `dimensions` entries used
+    double aic;                           // n ln(RSS / n) + 2K
+    double bic;                           // n ln(RSS / n) + K ln(n)
+};
+
+// Joint ACO over the order-4, -6 and -8 trajectory models. Each ant samples
+// all MAX_DIMENSIONS coefficients; one sweep over the samples accumulates the
+// x_t/y_t partial sums order by order and scores every model's prefix of the
+// ant. Pheromones are kept per coefficient block (theta[0..3], theta[4..5],
+// theta[6..7]) and deposited from the fitness of the order that introduces
+// the block. A lower order's best, padded with zeros, is adopted by a higher
+// order whose own best is worse, so the fitness never rises with the order.
+// Searches the PARAM_SET box; options.ranges is ignored. The stall
+// criterion counts iterations in which no order improved, and the target
+// criterion needs every order to reach it. Returns the iterations run.
+int nested_aco(const float ownship_x[], const float ownship_y[],
+               const float measure[], const basis_table &basis, int n,
+               unsigned int &random_state,
+               nested_result results[NESTED_ORDERS],
+               const aco_options &options = aco_options());
+
+// Index into results of the order with the lowest BIC
+int nested_select(const nested_result results[NESTED_ORDERS]);
+
+#endif // NESTED_H
@@ -0,0 +1,153 @@
+#include "ple.h"
+#include "lm.h"
+#include <cmath>
+
+using namespace std;
+
+bool ple_estimate(const float ownship_x[], const float ownship_y[],
+                  const float measure[], const basis_table &basis, int n,
+                  float theta[DIMENSIONS], float sigma[DIMENSIONS]) {
+    if (n <= DIMENSIONS)
+        return false;
+
+    // Scale each order's column to a peak of 1, i.e. normalised time. This
+    // keeps A^T A well conditioned for the higher-order terms.
+    double scale[DIMENSIONS / 2];
+    for (int k = 0; k < DIMENSIONS / 2; k++) {
+        double peak = 0.0;
+        for (int i = 0; i < n; i++)
+            peak = fmax(peak, fabs(static_cast<double>(basis.gamma[k][i])));
+        scale[k] = peak > 0.0 ? 1.0 / peak : 1.0;
+    }
+
+    double ata[DIMENSIONS][DIMENSIONS];
+    double atb[DIMENSIONS];
+    double phi[DIMENSIONS];
+    double variance = 0.0;
+
+    // Pass 0 is unweighted. Its residuals are range * sin(bearing error), so
+    // it favours short ranges; later passes divide each equation by the range
+    // predicted by the previous pass, turning the residuals into bearing
+    // errors. Pass 0 fits a constant-velocity track and each pass adds one
+    // order, so the higher-order terms are only fitted once the weights come
+    // from a sensible track.
+    int passes = DIMENSIONS / 2 - 2 + PLE_REWEIGHT_PASSES;
+    for (int pass = 0; pass <= passes; pass++) {
+        int active = 2 * (2 + pass);
+        if (active > DIMENSIONS)
+            active = DIMENSIONS;
+
+        for (int a = 0; a < DIMENSIONS; a++) {
+            atb[a] = 0.0;
+            for (int d = 0; d < DIMENSIONS; d++)
+                ata[a][d] = 0.0;
+        }
+        double btb = 0.0;
+
+        for (int i = 0; i < n; i++) {
+            double gamma[DIMENSIONS / 2];
+            for (int k = 0; k < DIMENSIONS / 2; k++)
+                gamma[k] = basis.gamma[k][i] * scale[k];
+
+            double s = sin(static_cast<double>(measure[i]));
+            double c = cos(static_cast<double>(measure[i]));
+            double b = s * ownship_x[i] - c * ownship_y[i];
+
+            double row[DIMENSIONS];
+            for (int k = 0; k < DIMENSIONS / 2; k++) {
+                row[2 * k] = s * gamma[k];
+                row[2 * k + 1] = -c * gamma[k];
+            }
+
+            double weight = 1.0;
+            if (pass > 0) {
+                double dx = -ownship_x[i], dy = -ownship_y[i];
+                for (int k = 0; k < DIMENSIONS / 2; k++) {
+                    dx += phi[2 * k] * gamma[k];
+                    dy += phi[2 * k + 1] * gamma[k];
+                }
+                double range2 = dx * dx + dy * dy;
+                weight = range2 > 0.0 ? 1.0 / range2 : 0.0;
+            }
+
+            for (int a = 0; a < DIMENSIONS; a++) {
+                atb[a] += weight * row[a] * b;
+                for (int d = a; d < DIMENSIONS; d++)
+                    ata[a][d] += weight * row[a] * row[d];
+            }
+            btb += weight * b * b;
+        }
+        for (int a = 0; a < DIMENSIONS; a++)
+            for (int d = 0; d < a; d++)
+                ata[a][d] = ata[d][a];
+
+        // Pin the inactive orders to zero
+        for (int a = active; a < DIMENSIONS; a++) {
+            for (int d = 0; d < DIMENSIONS; d++)
+                ata[a][d] = ata[d][a] = 0.0;
+            ata[a][a] = 1.0;
+            atb[a] = 0.0;
+        }
+
+        if (!cholesky_solve(ata, atb, phi))
+            return false;
+
+        // Residual sum of squares r^T W r = b^T W b - phi^T A^T W b
+        double rss = btb;
+        for (int a = 0; a < DIMENSIONS; a++)
+            rss -= phi[a] * atb[a];
+        variance = (rss > 0.0 ? rss : 0.0) / (n - active);
+    }
+
+    // Diagonal of (A^T A)^-1, one column at a time
+    double deviation[DIMENSIONS];
+    for (int a = 0; a < DIMENSIONS; a++) {
+        double unit[DIMENSIONS] = {};
+        double column[DIMENSIONS];
+        unit[a] = 1.0;
+        if (!cholesky_solve(ata, unit, column))
+            return false;
+
+        deviation[a] = sqrt(variance * column[a]);
+    }
+    for (int a = 0; a < DIMENSIONS; a++) {
+        theta[a] = static_cast<float>(phi[a] * scale[a / 2]);
+        sigma[a] = static_cast<float>(deviation[a] * scale[a / 2]);
+    }
+
+    return true;
+}
+
+bool ple_search_box(const float ownship_x[], const float ownship_y[],
+                    const float measure[], const basis_table &basis, int n,
+                    float ranges[DIMENSIONS][2], float sigmas) {
+    float theta[DIMENSIONS];
+    float sigma[DIMENSIONS];
+    if (!ple_estimate(ownship_x, ownship_y, measure, basis, n, theta,
+                      sigma))
+        return false;
+
+    // The pseudo-linear equations also hold with the target behind the
+    // ownship (bearing + pi), which the estimate can slip into over part of
+    // the track. A few LM steps on the bearing residuals pull it out; the box
+    // is then sized from the covariance at the polished point.
+    float fitness = objective_function(theta, ownship_x, ownship_y, measure, n,
+                                       basis);
+    lm_refine(ownship_x, ownship_y, measure, basis, theta, fitness, n,
+              PLE_LM_ITERATIONS);
+    lm_sigma(ownship_x, ownship_y, measure, basis, theta, n, sigma);
+
+    for (int d = 0; d < DIMENSIONS; d++) {
+        float half_width = sigmas * sigma[d];
+        float min_half_width = PLE_MIN_RELATIVE_WIDTH * fabsf(theta[d]);
+        if (half_width < min_half_width)
+            half_width = min_half_width;
+
+        ranges[d][0] = theta[d] - half_width;
+        ranges[d][1] = theta[d] + half_width;
+        DEBUG_PRINT("PLE theta[" << d << "] = " << theta[d] << " +/- "
+                                 << sigma[d]);
+    }
+
+    return true;
+}
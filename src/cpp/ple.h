@@ -0,0 +1,32 @@
+#ifndef PLE_H
+#define PLE_H
+
+#include "aco.h"
+
+#define PLE_SIGMAS 3.0f          // Search box half-width in standard deviations
+#define PLE_REWEIGHT_PASSES 3    // Extra range-weighted passes at full order
+#define PLE_LM_ITERATIONS 100    // LM polish of the estimate before sizing the box
+#define PLE_MIN_RELATIVE_WIDTH 0.05f // Minimum half-width relative to |estimate|
+
+// Pseudo-linear least squares estimate of theta. Each bearing gives one
+// equation that is linear in the trajectory coefficients:
+//   sin(h_i) x_t(t_i) - cos(h_i) y_t(t_i) = sin(h_i) x_o - cos(h_i) y_o
+// The first pass fits a constant-velocity track; each further pass adds one
+// order and weights every equation by 1 / range^2 from the previous pass, so
+// the residuals approximate bearing errors rather than cross-range distances.
+// sigma receives the standard deviation of each coefficient from the
+// covariance s^2 (A^T W A)^-1, with s^2 the residual variance. Returns false
+// if the normal equations are singular (e.g. no ownship manoeuvre).
+bool ple_estimate(const float ownship_x[], const float ownship_y[],
+                  const float measure[], const basis_table &basis, int n,
+                  float theta[DIMENSIONS], float sigma[DIMENSIONS]);
+
+// ACO search box around the pseudo-linear estimate after an LM polish:
+// theta +/- sigmas * sigma with sigma from lm_sigma() (the PLE covariance if
+// that fails), widened to at least PLE_MIN_RELATIVE_WIDTH * |theta| per
+// coefficient. Returns false (ranges untouched) if the estimate failed.
+bool ple_search_box(const float ownship_x[], const float ownship_y[],
+                    const float measure[], const basis_table &basis, int n,
+                    float ranges[DIMENSIONS][2], float sigmas = PLE_SIGMAS);
+
+#endif // PLE_H
@@ -0,0 +1,183 @@
+#include "prune.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+float prune_bound(const float ranges[DIMENSIONS][2], const float ownship_x[],
+                  const float ownship_y[], const float measure[],
+                  const basis_table &basis, int n) {
+    double bound = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        // Interval of the target-ownship offset
+        double x_lo = -ownship_x[i], x_hi = -ownship_x[i];
+        double y_lo = -ownship_y[i], y_hi = -ownship_y[i];
+        for (int k = 0; k < DIMENSIONS / 2; k++) {
+            double gamma = basis.gamma[k][i];
+            double a = ranges[2 * k][0] * gamma, b = ranges[2 * k][1] * gamma;
+            x_lo += fmin(a, b);
+            x_hi += fmax(a, b);
+            a = ranges[2 * k + 1][0] * gamma;
+            b = ranges[2 * k + 1][1] * gamma;
+            y_lo += fmin(a, b);
+            y_hi += fmax(a, b);
+        }
+
+        // Any bearing if the box holds the ownship or crosses the branch cut
+        if (x_lo <= 0.0 && y_lo <= 0.0 && y_hi >= 0.0)
+            continue;
+
+        double h_lo = atan2(y_lo, x_lo), h_hi = h_lo;
+        double corners[3] = {atan2(y_lo, x_hi), atan2(y_hi, x_lo),
+                             atan2(y_hi, x_hi)};
+        for (double h : corners) {
+            h_lo = fmin(h_lo, h);
+            h_hi = fmax(h_hi, h);
+        }
+
+        double diff = 0.0;
+        if (measure[i] < h_lo)
+            diff = h_lo - measure[i];
+        else if (measure[i] > h_hi)
+            diff = measure[i] - h_hi;
+        bound += diff * diff;
+    }
+
+    return static_cast<float>(bound);
+}
+
+static void prune_index(prune_set &set) {
+    set.cumulative.resize(set.cells.size());
+    double total = 0.0;
+    for (size_t c = 0; c < set.cells.size(); c++) {
+        total += set.cells[c].volume;
+        set.cumulative[c] = total;
+    }
+}
+
+static inline bool prune_keep(float bound, float incumbent) {
+    return bound <= incumbent * (1.0f + PRUNE_SLACK);
+}
+
+int prune_build(const float ownship_x[], const float ownship_y[],
+                const float measure[], const basis_table &basis, int n,
+                const float ranges[DIMENSIONS][2], float incumbent,
+                int max_cells, prune_set &set) {
+    // How far each coefficient can move the trajectory per unit width
+    float reach[DIMENSIONS];
+    for (int d = 0; d < DIMENSIONS; d++) {
+        float peak = 0.0f;
+        for (int i = 0; i < n; i++)
+            peak = fmaxf(peak, fabsf(basis.gamma[d / 2][i]));
+        reach[d] = peak;
+    }
+
+    prune_cell root;
+    for (int d = 0; d < DIMENSIONS; d++) {
+        root.ranges[d][0] = ranges[d][0];
+        root.ranges[d][1] = ranges[d][1];
+    }
+    root.volume = 1.0;
+    root.bound = prune_bound(root.ranges, ownship_x, ownship_y, measure, basis,
+                             n);
+
+    set.cells.clear();
+    vector<prune_cell> queue;
+    queue.push_back(root);
+    int evaluations = 1;
+    size_t head = 0;
+
+    while (head < queue.size()) {
+        prune_cell cell = queue[head++];
+        int pending = static_cast<int>(set.cells.size() + queue.size() - head);
+
+        if (pending + 2 > max_cells ||
+            evaluations + 2 > PRUNE_EVALUATIONS * max_cells) {
+            set.cells.push_back(cell);
+            continue;
+        }
+
+        int split = 0;
+        for (int d = 1; d < DIMENSIONS; d++) {
+            if ((cell.ranges[d][1] - cell.ranges[d][0]) * reach[d] >
+                (cell.ranges[split][1] - cell.ranges[split][0]) * reach[split])
+                split = d;
+        }
+        float middle = 0.5f * (cell.ranges[split][0] + cell.ranges[split][1]);
+
+        for (int half = 0; half < 2; half++) {
+            prune_cell child = cell;
+            child.ranges[split][half ? 0 : 1] = middle;
+            child.volume = 0.5 * cell.volume;
+            child.bound = prune_bound(child.ranges, ownship_x, ownship_y,
+                                      measure, basis, n);
+            evaluations++;
+            if (prune_keep(child.bound, incumbent))
+                queue.push_back(child);
+        }
+    }
+
+    // An incumbent from outside the box can prune it entirely; fall back to
+    // the whole box rather than leave nothing to sample
+    if (set.cells.empty())
+        set.cells.push_back(root);
+
+    prune_index(set);
+    DEBUG_PRINT("Pruning kept " << set.cells.size() << " cells, volume "
+                                << set.cumulative.back() << ", "
+                                << evaluations << " bounds");
+    return static_cast<int>(set.cells.size());
+}
+
+int prune_update(prune_set &set, float incumbent) {
+    size_t kept = 0;
+    for (size_t c = 0; c < set.cells.size(); c++) {
+        if (prune_keep(set.cells[c].bound, incumbent))
+            set.cells[kept++] = set.cells[c];
+    }
+
+    // The cell holding the incumbent always survives, barring rounding
+    if (kept > 0 && kept < set.cells.size()) {
+        set.cells.resize(kept);
+        prune_index(set);
+    }
+    return static_cast<int>(set.cells.size());
+}
+
+bool prune_contains(const prune_set &set, const float theta[DIMENSIONS]) {
+    for (const prune_cell &cell : set.cells) {
+        bool inside = true;
+        for (int d = 0; d < DIMENSIONS && inside; d++)
+            inside = theta[d] >= cell.ranges[d][0] &&
+                     theta[d] <= cell.ranges[d][1];
+        if (inside)
+            return true;
+    }
+    return false;
+}
+
+const prune_cell &prune_sample(const prune_set &set, float random_value) {
+    double target = random_value * set.cumulative.back();
+    size_t c = upper_bound(set.cumulative.begin(), set.cumulative.end(),
+                           target) -
+               set.cumulative.begin();
+    return set.cells[c < set.cells.size() ? c : set.cells.size() - 1];
+}
+
+void colony_prune(colony_state &colony, prune_set &set, int iter,
+                  int max_cells, const float ownship_x[],
+                  const float ownship_y[], const float measure[],
+                  const basis_table &basis, int n) {
+    if (max_cells <= 1 || colony.best_fitness == numeric_limits<float>::max())
+        return;
+
+    if (!colony.prune) {
+        prune_build(ownship_x, ownship_y, measure, basis, n, colony.ranges,
+                    colony.best_fitness, max_cells, set);
+        colony.prune = &set;
+    } else if (iter % PRUNE_INTERVAL == 0) {
+        prune_update(set, colony.best_fitness);
+    }
+}
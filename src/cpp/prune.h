@@ -0,0 +1,61 @@
+#ifndef PRUNE_H
+#define PRUNE_H
+
+#include "aco.h"
+#include <vector>
+
+#define PRUNE_INTERVAL 10       // Iterations between re-pruning against the incumbent
+#define PRUNE_EVALUATIONS 4     // Bound evaluations per cell when building
+#define PRUNE_SLACK 1e-3f       // Relative margin for rounding in the objective
+
+// Sub-box of the search box with a lower bound on objective_function()
+struct prune_cell {
+    float ranges[DIMENSIONS][2];
+    float bound;
+    double volume; // share of the root box
+};
+
+// Cells that may still hold a solution better than the incumbent
+struct prune_set {
+    std::vector<prune_cell> cells;
+    std::vector<double> cumulative; // running volume, for sampling
+};
+
+// Lower bound on objective_function() over the box. Each sample's x_t/y_t is
+// bounded by interval arithmetic on the basis table, and the bearing by the
+// corners of that interval box: atan2 has no interior extremum on a box that
+// neither contains the ownship nor crosses the branch cut on the negative x
+// axis. Such samples contribute nothing.
+float prune_bound(const float ranges[DIMENSIONS][2], const float ownship_x[],
+                  const float ownship_y[], const float measure[],
+                  const basis_table &basis, int n);
+
+// Branch and bound over ranges: cells are bisected breadth first along the
+// coefficient that moves the trajectory furthest, and cells whose bound
+// exceeds the incumbent are dropped. Stops at max_cells cells or after
+// PRUNE_EVALUATIONS * max_cells bounds. Returns the surviving cell count.
+int prune_build(const float ownship_x[], const float ownship_y[],
+                const float measure[], const basis_table &basis, int n,
+                const float ranges[DIMENSIONS][2], float incumbent,
+                int max_cells, prune_set &set);
+
+// Drop cells whose bound exceeds the (improved) incumbent. The bounds are
+// not recomputed. Returns the surviving cell count.
+int prune_update(prune_set &set, float incumbent);
+
+// Whether theta lies in a surviving cell
+bool prune_contains(const prune_set &set, const float theta[DIMENSIONS]);
+
+// Cell for an ant, chosen in proportion to volume, so sampling stays uniform
+// over the surviving part of the box
+const prune_cell &prune_sample(const prune_set &set, float random_value);
+
+// Called by the ACO loops at each iteration boundary. Builds the colony's
+// cells once it has an incumbent, re-prunes them every PRUNE_INTERVAL
+// iterations, and points colony.prune at them.
+void colony_prune(colony_state &colony, prune_set &set, int iter,
+                  int max_cells, const float ownship_x[],
+                  const float ownship_y[], const float measure[],
+                  const basis_table &basis, int n);
+
+#endif // PRUNE_H
@@ -70,7 +70,7 @@ for input_file in "${input_files[@]}"; do
     # Loop over selected dimensions
     for numvars in "${dimensions[@]}"; do
         echo "Compiling: DIMENSIONS=$numvars"
-        g++ -DDIMENSIONS=$numvars -DSAMPLING_TIME=$SAMPLING_TIME -DPARAM_SET=$PARAM_SET -o aco aco.cpp
+        g++ -DDIMENSIONS=$numvars -DPARAM_SET=$PARAM_SET -pthread -o aco aco.cpp compact.cpp island.cpp lm.cpp nested.cpp ple.cpp prune.cpp main.cpp
 
         for seed in $(seq "$start_seed" "$end_seed"); do
             echo "-> Running SEED=$seed"
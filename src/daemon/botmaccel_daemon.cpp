@@ -0,0 +1,546 @@
+#include "botmaccel_daemon.h"
+#include "aco.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+#define DAEMON_BATCH 8              // Default requests a worker takes at once
+#define DAEMON_LATENCY_WINDOW 4096  // Requests behind the latency percentiles
+#define DAEMON_CONTACT_TTL 600.0    // Seconds before idle warm state is dropped
+#define DAEMON_SWEEP_INTERVAL 60    // Seconds between sweeps for idle contacts
+#define DAEMON_PRUNE_CELLS 64       // Default branch-and-bound cells per solve
+
+static_assert(MAX_DIMENSIONS == DAEMON_MAX_DIMENSIONS,
+              "wire format carries MAX_DIMENSIONS coefficients");
+
+typedef chrono::steady_clock daemon_clock;
+
+static double seconds_between(daemon_clock::time_point from,
+                              daemon_clock::time_point to) {
+    return chrono::duration<double>(to - from).count();
+}
+
+// Client connection. Workers write responses under write_mutex; the socket
+// is closed once the reader and all queued requests are done with it.
+struct connection {
+    int fd;
+    mutex write_mutex;
+
+    explicit connection(int fd) : fd(fd) {}
+    ~connection() { close(fd); }
+
+    void send(const daemon_response &response, const void *payload = nullptr,
+              size_t payload_size = 0) {
+        lock_guard<mutex> lock(write_mutex);
+        if (write_all(fd, &response, sizeof(response)) && payload)
+            write_all(fd, payload, payload_size);
+    }
+};
+
+struct solve_request {
+    shared_ptr<connection> client;
+    daemon_request header;
+    vector<float> timeframe, ownship_x, ownship_y, measure;
+    daemon_clock::time_point received;
+    // Older queued requests for the same contact, answered with this result
+    vector<solve_request> superseded;
+};
+
+// Warm state kept per contact between requests
+struct contact_state {
+    float best_solution[DIMENSIONS];
+    daemon_clock::time_point received; // of the update best_solution fits
+    daemon_clock::time_point last_seen;
+};
+
+struct daemon_options {
+    int workers = 0; // 0 = hardware threads
+    int batch = DAEMON_BATCH;
+    double budget_seconds = 0.0;
+    int prune_cells = DAEMON_PRUNE_CELLS;
+};
+
+class solver_daemon {
+  public:
+    explicit solver_daemon(const daemon_options &options);
+    ~solver_daemon();
+
+    void serve(shared_ptr<connection> client);
+    void stop();
+
+  private:
+    void worker_loop();
+    void solve(solve_request &request, basis_table &basis, int batch_size);
+    void respond(solve_request &request, daemon_response response);
+    void record(float latency, const daemon_response &response);
+    void fill_stats(daemon_stats &stats);
+
+    daemon_options options;
+
+    mutex queue_mutex;
+    condition_variable work_ready;
+    deque<solve_request> queue;
+    size_t max_queue_depth = 0;
+    uint64_t batches = 0;
+    bool stopping = false;
+    vector<thread> workers;
+
+    mutex contact_mutex;
+    unordered_map<uint64_t, contact_state> contacts;
+    daemon_clock::time_point next_sweep = daemon_clock::now();
+
+    mutex stats_mutex;
+    vector<float> latencies, queue_waits; // rings of DAEMON_LATENCY_WINDOW
+    uint64_t requests = 0;
+    uint64_t superseded = 0;
+};
+
+solver_daemon::solver_daemon(const daemon_options &options)
+    : options(options) {
+    int count = options.workers > 0 ? options.workers
+                                    : static_cast<int>(
+                                          thread::hardware_concurrency());
+    if (count < 1)
+        count = 1;
+    this->options.workers = count;
+    for (int w = 0; w < count; w++)
+        workers.emplace_back(&solver_daemon::worker_loop, this);
+}
+
+solver_daemon::~solver_daemon() { stop(); }
+
+void solver_daemon::stop() {
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for (thread &worker : workers)
+        worker.join();
+    workers.clear();
+
+    // Workers finish the batch they hold; whatever is still queued is
+    // answered rather than left hanging
+    deque<solve_request> pending;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        pending.swap(queue);
+    }
+    daemon_response response = {};
+    response.magic = DAEMON_MAGIC;
+    response.version = DAEMON_VERSION;
+    response.type = DAEMON_SOLVE;
+    response.status = DAEMON_SHUTDOWN;
+    for (solve_request &request : pending) {
+        for (solve_request &older : request.superseded)
+            respond(older, response);
+        respond(request, response);
+    }
+}
+
+// Reads requests from one connection until it closes
+void solver_daemon::serve(shared_ptr<connection> client) {
+    daemon_request header;
+    while (read_all(client->fd, &header, sizeof(header))) {
+        daemon_response response = {};
+        response.magic = DAEMON_MAGIC;
+        response.version = DAEMON_VERSION;
+        response.request_id = header.request_id;
+        response.type = header.type;
+
+        if (header.magic != DAEMON_MAGIC || header.version != DAEMON_VERSION)
+            break; // out of sync, drop the connection
+
+        if (header.type == DAEMON_STATS) {
+            daemon_stats stats;
+            fill_stats(stats);
+            response.status = DAEMON_OK;
+            client->send(response, &stats, sizeof(stats));
+            continue;
+        }
+
+        // Too long to buffer: reject and drop the connection
+        if (header.n > MAX_ENTRIES) {
+            response.status = DAEMON_BAD_REQUEST;
+            client->send(response);
+            break;
+        }
+
+        // Read the samples even if the request is rejected, to stay in sync
+        vector<daemon_sample> samples(header.n);
+        if (header.n > 0 &&
+            !read_all(client->fd, samples.data(),
+                      samples.size() * sizeof(daemon_sample)))
+            break;
+
+        if (header.type != DAEMON_SOLVE || header.dimensions != DIMENSIONS ||
+            header.n < 1) {
+            response.status = DAEMON_BAD_REQUEST;
+            client->send(response);
+            continue;
+        }
+
+        solve_request request;
+        request.client = client;
+        request.header = header;
+        request.received = daemon_clock::now();
+        request.timeframe.resize(header.n);
+        request.ownship_x.resize(header.n);
+        request.ownship_y.resize(header.n);
+        request.measure.resize(header.n);
+        for (uint32_t i = 0; i < header.n; i++) {
+            request.timeframe[i] = samples[i].time;
+            request.ownship_x[i] = samples[i].ownship_x;
+            request.ownship_y[i] = samples[i].ownship_y;
+            request.measure[i] = samples[i].measure;
+        }
+
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            // Only the newest queued track of a contact is worth solving
+            if (header.contact_id != 0) {
+                for (auto it = queue.begin(); it != queue.end(); ++it) {
+                    if (it->header.contact_id == header.contact_id) {
+                        request.superseded = move(it->superseded);
+                        request.superseded.push_back(move(*it));
+                        request.superseded.back().superseded.clear();
+                        queue.erase(it);
+                        break;
+                    }
+                }
+            }
+            queue.push_back(move(request));
+            max_queue_depth = max(max_queue_depth, queue.size());
+        }
+        work_ready.notify_one();
+    }
+}
+
+void solver_daemon::worker_loop() {
+    // Per-worker scratch, reused for every request
+    unique_ptr<basis_table> basis(new basis_table);
+    vector<solve_request> batch;
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            work_ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping)
+                return;
+
+            // Take a fair share of the queue, at most options.batch requests
+            size_t share = (queue.size() + options.workers - 1) /
+                           static_cast<size_t>(options.workers);
+            size_t take = min(share, static_cast<size_t>(options.batch));
+            if (take < 1)
+                take = 1;
+            for (size_t r = 0; r < take; r++) {
+                batch.push_back(move(queue.front()));
+                queue.pop_front();
+            }
+            batches++;
+        }
+
+        for (solve_request &request : batch)
+            solve(request, *basis, static_cast<int>(batch.size()));
+        batch.clear();
+    }
+}
+
+void solver_daemon::solve(solve_request &request, basis_table &basis,
+                          int batch_size) {
+    auto start = daemon_clock::now();
+    const daemon_request &header = request.header;
+    int n = static_cast<int>(header.n);
+
+    build_basis(request.timeframe.data(), n, basis);
+
+    aco_options aco_opts;
+    if (header.iterations > 0)
+        aco_opts.iterations = static_cast<int>(header.iterations);
+    aco_opts.budget_seconds = header.budget_seconds > 0.0f
+                                  ? header.budget_seconds
+                                  : options.budget_seconds;
+    aco_opts.prune_cells = options.prune_cells;
+
+    // Warm start from the contact's last solution. The new track can move the
+    // optimum well away from it, so the whole box is still searched; the warm
+    // incumbent lets pruning discard most of it before the first iteration.
+    float warm_solution[DIMENSIONS];
+    bool warm = false;
+    if (header.contact_id != 0) {
+        lock_guard<mutex> lock(contact_mutex);
+        auto it = contacts.find(header.contact_id);
+        if (it != contacts.end()) {
+            warm = true;
+            copy(it->second.best_solution,
+                 it->second.best_solution + DIMENSIONS, warm_solution);
+        }
+    }
+    if (warm)
+        aco_opts.warm_start = warm_solution;
+
+    float best_fitness;
+    float best_solution[DIMENSIONS];
+    unsigned int random_state = header.seed;
+    int iterations = aco(request.ownship_x.data(), request.ownship_y.data(),
+                         request.measure.data(), basis, best_fitness,
+                         best_solution, n, random_state, aco_opts);
+    auto end = daemon_clock::now();
+
+    if (header.contact_id != 0) {
+        lock_guard<mutex> lock(contact_mutex);
+        // Two updates of a contact can be solved at once by different
+        // workers; keep the newer update's result whichever finishes last
+        auto inserted = contacts.emplace(header.contact_id, contact_state());
+        contact_state &contact = inserted.first->second;
+        if (inserted.second || request.received > contact.received) {
+            copy(best_solution, best_solution + DIMENSIONS,
+                 contact.best_solution);
+            contact.received = request.received;
+        }
+        contact.last_seen = end;
+
+        // Forget contacts the tracker has dropped. The sweep walks the whole
+        // map, so it runs once per DAEMON_SWEEP_INTERVAL, not per solve.
+        if (end >= next_sweep) {
+            for (auto it = contacts.begin(); it != contacts.end();) {
+                if (seconds_between(it->second.last_seen, end) >
+                    DAEMON_CONTACT_TTL)
+                    it = contacts.erase(it);
+                else
+                    ++it;
+            }
+            next_sweep = end + chrono::seconds(DAEMON_SWEEP_INTERVAL);
+        }
+    }
+
+    daemon_response response = {};
+    response.magic = DAEMON_MAGIC;
+    response.version = DAEMON_VERSION;
+    response.type = DAEMON_SOLVE;
+    response.iterations = static_cast<uint32_t>(iterations);
+    response.warm = warm ? 1 : 0;
+    response.batch_size = static_cast<uint32_t>(batch_size);
+    response.best_fitness = best_fitness;
+    copy(best_solution, best_solution + DIMENSIONS, response.best_solution);
+    response.solve_seconds = static_cast<float>(seconds_between(start, end));
+
+    response.status = DAEMON_SUPERSEDED;
+    for (solve_request &older : request.superseded) {
+        response.queue_seconds =
+            static_cast<float>(seconds_between(older.received, start));
+        respond(older, response);
+    }
+
+    response.status = DAEMON_OK;
+    response.queue_seconds =
+        static_cast<float>(seconds_between(request.received, start));
+    respond(request, response);
+}
+
+void solver_daemon::respond(solve_request &request, daemon_response response) {
+    response.request_id = request.header.request_id;
+
+    // Recorded before the send, so a client that asks for statistics after
+    // its last response sees that response counted
+    float latency = static_cast<float>(
+        seconds_between(request.received, daemon_clock::now()));
+    record(latency, response);
+
+    request.client->send(response);
+}
+
+void solver_daemon::record(float latency, const daemon_response &response) {
+    lock_guard<mutex> lock(stats_mutex);
+    size_t slot = requests % DAEMON_LATENCY_WINDOW;
+    if (latencies.size() < DAEMON_LATENCY_WINDOW) {
+        latencies.push_back(latency);
+        queue_waits.push_back(response.queue_seconds);
+    } else {
+        latencies[slot] = latency;
+        queue_waits[slot] = response.queue_seconds;
+    }
+    requests++;
+    if (response.status == DAEMON_SUPERSEDED)
+        superseded++;
+}
+
+// Nearest-rank percentile
+static float percentile(vector<float> values, float p) {
+    if (values.empty())
+        return 0.0f;
+    size_t rank = static_cast<size_t>(p * (values.size() - 1) + 0.5f);
+    nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+void solver_daemon::fill_stats(daemon_stats &stats) {
+    stats = {};
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stats.queue_depth = static_cast<uint32_t>(queue.size());
+        stats.max_queue_depth = static_cast<uint32_t>(max_queue_depth);
+        stats.batches = batches;
+    }
+    {
+        lock_guard<mutex> lock(contact_mutex);
+        stats.contacts = static_cast<uint32_t>(contacts.size());
+    }
+    stats.workers = static_cast<uint32_t>(options.workers);
+
+    vector<float> latency_copy, queue_copy;
+    {
+        lock_guard<mutex> lock(stats_mutex);
+        stats.requests = requests;
+        stats.superseded = superseded;
+        latency_copy = latencies;
+        queue_copy = queue_waits;
+    }
+    stats.samples = static_cast<uint32_t>(latency_copy.size());
+    stats.latency_p50 = percentile(latency_copy, 0.50f);
+    stats.latency_p95 = percentile(latency_copy, 0.95f);
+    stats.latency_p99 = percentile(latency_copy, 0.99f);
+    stats.queue_p50 = percentile(queue_copy, 0.50f);
+    stats.queue_p95 = percentile(queue_copy, 0.95f);
+    stats.queue_p99 = percentile(queue_copy, 0.99f);
+}
+
+static volatile sig_atomic_t shutdown_requested = 0;
+
+static void on_signal(int) { shutdown_requested = 1; }
+
+void print_usage(const char *program) {
+    cerr << "Usage: " << program << " [options]\n"
+         << "  --socket PATH  Unix socket to listen on (default "
+         << DAEMON_SOCKET << ")\n"
+         << "  --workers N    solver threads (default: hardware threads)\n"
+         << "  --batch N      requests a worker takes at once (default "
+         << DAEMON_BATCH << ")\n"
+         << "  --budget S     default wall-clock budget per solve in "
+            "seconds\n"
+         << "  --prune N      branch-and-bound cells per solve, 0 disables "
+            "(default "
+         << DAEMON_PRUNE_CELLS << ")\n";
+}
+
+int main(int argc, char *argv[]) {
+    const char *socket_path = DAEMON_SOCKET;
+    daemon_options options;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            options.workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            options.batch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            options.budget_seconds = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--prune") == 0 && i + 1 < argc) {
+            options.prune_cells = atoi(argv[++i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.batch < 1 || strlen(socket_path) >= sizeof(sockaddr_un::sun_path)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        cerr << "Error: socket: " << strerror(errno) << endl;
+        return 1;
+    }
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+    unlink(socket_path);
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+        listen(listener, SOMAXCONN) < 0) {
+        cerr << "Error: " << socket_path << ": " << strerror(errno) << endl;
+        close(listener);
+        return 1;
+    }
+
+    // Accept must return on SIGINT/SIGTERM, so no SA_RESTART
+    struct sigaction action = {};
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN); // clients may leave before their response
+
+    solver_daemon solver(options);
+    cout << "Listening on " << socket_path << " (DIMENSIONS=" << DIMENSIONS
+         << ", PARAM_SET=" << PARAM_SET << ")" << endl;
+
+    // Reader threads are tracked so shutdown can wake and wait for them
+    mutex readers_mutex;
+    condition_variable readers_done;
+    vector<shared_ptr<connection>> open_connections;
+    int readers = 0;
+
+    while (!shutdown_requested) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR)
+                continue;
+            cerr << "Error: accept: " << strerror(errno) << endl;
+            break;
+        }
+
+        auto client = make_shared<connection>(fd);
+        {
+            lock_guard<mutex> lock(readers_mutex);
+            // Drop connections whose reader has finished
+            open_connections.erase(
+                remove_if(open_connections.begin(), open_connections.end(),
+                          [](const shared_ptr<connection> &c) {
+                              return c.use_count() == 1;
+                          }),
+                open_connections.end());
+            open_connections.push_back(client);
+            readers++;
+        }
+        thread([&, client] {
+            solver.serve(client);
+            lock_guard<mutex> lock(readers_mutex);
+            readers--;
+            readers_done.notify_all();
+        }).detach();
+    }
+
+    close(listener);
+    unlink(socket_path);
+
+    // Wake the readers, then stop the workers; queued requests are answered
+    // with DAEMON_SHUTDOWN
+    {
+        unique_lock<mutex> lock(readers_mutex);
+        for (const shared_ptr<connection> &client : open_connections)
+            shutdown(client->fd, SHUT_RD);
+        readers_done.wait(lock, [&] { return readers == 0; });
+    }
+    solver.stop();
+    cout << "Stopped" << endl;
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+#ifndef BOTMACCEL_DAEMON_H
+#define BOTMACCEL_DAEMON_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
+
+// Wire format of the solver daemon. Both ends run on the same host, so the
+// structures travel in native byte order and layout. Every message starts
+// with a fixed header:
+//   client -> daemon: daemon_request, then n daemon_sample for DAEMON_SOLVE
+//   daemon -> client: daemon_response, then daemon_stats for DAEMON_STATS
+// A connection may carry any number of requests. Responses carry the
+// request_id and may arrive out of order.
+
+#define DAEMON_MAGIC 0x4D544F42u         // "BOTM"
+#define DAEMON_VERSION 1
+#define DAEMON_SOCKET "/tmp/botmaccel.sock" // Default socket path
+#define DAEMON_MAX_DIMENSIONS 8
+
+enum daemon_type : uint16_t {
+    DAEMON_SOLVE = 1, // fit a track
+    DAEMON_STATS = 2, // queue depth and latency percentiles
+};
+
+enum daemon_status : uint16_t {
+    DAEMON_OK = 0,
+    DAEMON_SUPERSEDED = 1, // a newer request for the contact was queued
+                           // first; the response carries its solution
+    DAEMON_BAD_REQUEST = 2,
+    DAEMON_SHUTDOWN = 3, // the daemon stopped before solving it
+};
+
+struct daemon_request {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t type;
+    uint64_t request_id; // echoed in the response
+    uint64_t contact_id; // warm state key, 0 = stateless
+    uint32_t n;          // samples that follow
+    uint32_t dimensions; // must match the daemon build
+    uint32_t seed;
+    uint32_t iterations;  // 0 = ITERATIONS
+    float budget_seconds; // 0 = daemon default
+    uint32_t reserved;
+};
+
+// One CSV row. Times of a contact must share its time origin between
+// requests for the warm state to apply.
+struct daemon_sample {
+    float time;
+    float ownship_x;
+    float ownship_y;
+    float measure;
+};
+
+struct daemon_response {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t status;
+    uint64_t request_id;
+    uint32_t type;
+    uint32_t iterations; // ACO iterations run
+    uint32_t warm;       // 1 if the contact's previous solution seeded it
+    uint32_t batch_size; // requests taken by the worker with this one
+    float best_fitness;
+    float best_solution[DAEMON_MAX_DIMENSIONS];
+    float queue_seconds; // receipt to solve start
+    float solve_seconds;
+    uint32_t reserved;
+};
+
+struct daemon_stats {
+    uint32_t queue_depth;
+    uint32_t max_queue_depth;
+    uint32_t workers;
+    uint32_t contacts; // contacts with warm state
+    uint64_t requests; // solves answered, including superseded
+    uint64_t batches;
+    uint64_t superseded;
+    uint32_t samples; // latencies behind the percentiles
+    // Receipt to response, over the last DAEMON_LATENCY_WINDOW requests
+    float latency_p50;
+    float latency_p95;
+    float latency_p99;
+    float queue_p50; // receipt to solve start
+    float queue_p95;
+    float queue_p99;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(daemon_request) == 48, "daemon_request layout");
+static_assert(sizeof(daemon_sample) == 16, "daemon_sample layout");
+static_assert(sizeof(daemon_response) == 80, "daemon_response layout");
+static_assert(sizeof(daemon_stats) == 72, "daemon_stats layout");
+
+// Blocking helpers that retry short transfers. Return false on EOF or error.
+inline bool read_all(int fd, void *data, size_t size) {
+    char *p = static_cast<char *>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, p, size);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            return false;
+        p += got;
+        size -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+inline bool write_all(int fd, const void *data, size_t size) {
+    const char *p = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t put = write(fd, p, size);
+        if (put < 0 && errno == EINTR)
+            continue;
+        if (put <= 0)
+            return false;
+        p += put;
+        size -= static_cast<size_t>(put);
+    }
+    return true;
+}
+
+#endif // BOTMACCEL_DAEMON_H
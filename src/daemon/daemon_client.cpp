@@ -0,0 +1,237 @@
+#include "botmaccel_daemon.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+bool load_data(const char *file_path, vector<daemon_sample> &track) {
+    ifstream file(file_path);
+    if (!file) {
+        cerr << "Error: Unable to open input file: " << file_path << endl;
+        return false;
+    }
+
+    string line;
+    getline(file, line); // header
+
+    while (getline(file, line)) {
+        if (line.empty())
+            continue;
+        stringstream ss(line);
+        daemon_sample sample;
+        char comma;
+        ss >> sample.time >> comma >> sample.ownship_x >> comma >>
+            sample.ownship_y >> comma >> sample.measure;
+        track.push_back(sample);
+    }
+    return !track.empty();
+}
+
+int connect_daemon(const char *socket_path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+        0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+daemon_request make_request(uint16_t type, uint64_t request_id) {
+    daemon_request request = {};
+    request.magic = DAEMON_MAGIC;
+    request.version = DAEMON_VERSION;
+    request.type = type;
+    request.request_id = request_id;
+    return request;
+}
+
+void print_usage(const char *program) {
+    cerr << "Usage: " << program << " [options] <input.csv>\n"
+         << "  --socket PATH    daemon socket (default " << DAEMON_SOCKET
+         << ")\n"
+         << "  --dimensions D   model order of the daemon build (default 4)\n"
+         << "  --contacts C     contacts tracked concurrently (default 4)\n"
+         << "  --updates U      track updates per contact (default 4)\n"
+         << "  --iterations N   ACO iterations per solve (default: daemon)\n"
+         << "  --budget S       wall-clock budget per solve in seconds\n"
+         << "  --pipeline       send a contact's updates without waiting "
+            "for responses\n";
+}
+
+// Plays a tracker: each contact sends its track in `updates` growing
+// prefixes on its own connection, the way a tracker would as bearings
+// arrive, and prints every response. With --pipeline the updates go out
+// back to back, so the daemon sees them queued together.
+int main(int argc, char *argv[]) {
+    const char *socket_path = DAEMON_SOCKET;
+    const char *input = nullptr;
+    int dimensions = 4;
+    int contacts = 4;
+    int updates = 4;
+    int iterations = 0;
+    float budget = 0.0f;
+    bool pipeline = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--dimensions") == 0 && i + 1 < argc) {
+            dimensions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--contacts") == 0 && i + 1 < argc) {
+            contacts = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc) {
+            updates = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = static_cast<float>(atof(argv[++i]));
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            pipeline = true;
+        } else if (!input && argv[i][0] != '-') {
+            input = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (!input || contacts < 1 || updates < 1 || dimensions < 1 ||
+        dimensions > DAEMON_MAX_DIMENSIONS) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    vector<daemon_sample> track;
+    if (!load_data(input, track))
+        return 1;
+
+    signal(SIGPIPE, SIG_IGN); // a stopped daemon fails the send instead
+
+    mutex print_mutex;
+    atomic<int> failures{0};
+
+    auto run_contact = [&](int contact) {
+        int fd = connect_daemon(socket_path);
+        if (fd < 0) {
+            lock_guard<mutex> lock(print_mutex);
+            cerr << "Error: cannot connect to " << socket_path << endl;
+            failures++;
+            return;
+        }
+
+        auto send_update = [&](int u) {
+            size_t n = track.size() * u / updates;
+            daemon_request request =
+                make_request(DAEMON_SOLVE, static_cast<uint64_t>(u));
+            request.contact_id = contact + 1;
+            request.n = static_cast<uint32_t>(n);
+            request.dimensions = static_cast<uint32_t>(dimensions);
+            request.seed = static_cast<uint32_t>(contact + 1);
+            request.iterations = static_cast<uint32_t>(iterations);
+            request.budget_seconds = budget;
+            return write_all(fd, &request, sizeof(request)) &&
+                   write_all(fd, track.data(), n * sizeof(daemon_sample));
+        };
+
+        // Pipelined updates are all sent up front; otherwise each waits for
+        // the previous response
+        bool ok = true;
+        auto sent = chrono::steady_clock::now();
+        for (int u = 1; pipeline && ok && u <= updates; u++)
+            ok = send_update(u);
+
+        for (int u = 1; ok && u <= updates; u++) {
+            if (!pipeline) {
+                sent = chrono::steady_clock::now();
+                ok = send_update(u);
+            }
+
+            daemon_response response;
+            if (!ok || !read_all(fd, &response, sizeof(response))) {
+                failures++;
+                break;
+            }
+            double round_trip = chrono::duration<double>(
+                                    chrono::steady_clock::now() - sent)
+                                    .count();
+            int update = static_cast<int>(response.request_id);
+            size_t n = track.size() * update / updates;
+
+            lock_guard<mutex> lock(print_mutex);
+            if (response.status == DAEMON_BAD_REQUEST) {
+                cerr << "Contact " << contact + 1
+                     << ": request rejected (check --dimensions)" << endl;
+                failures++;
+                break;
+            }
+            if (response.status == DAEMON_SHUTDOWN) {
+                cerr << "Contact " << contact + 1 << ": daemon shut down"
+                     << endl;
+                failures++;
+                break;
+            }
+            cout << "Contact " << contact + 1 << ", update " << update << " ("
+                 << n << " samples" << (response.warm ? ", warm" : "")
+                 << (response.status == DAEMON_SUPERSEDED ? ", superseded"
+                                                          : "")
+                 << "): fitness " << response.best_fitness << ", "
+                 << response.iterations << " iterations, round trip "
+                 << round_trip * 1e3 << " ms\n  Solution:";
+            for (int d = 0; d < dimensions; d++)
+                cout << " " << response.best_solution[d];
+            cout << endl;
+        }
+        close(fd);
+    };
+
+    vector<thread> threads;
+    for (int c = 0; c < contacts; c++)
+        threads.emplace_back(run_contact, c);
+    for (thread &t : threads)
+        t.join();
+
+    // Daemon statistics
+    int fd = connect_daemon(socket_path);
+    daemon_request request = make_request(DAEMON_STATS, 0);
+    daemon_response response;
+    daemon_stats stats;
+    if (fd < 0 || !write_all(fd, &request, sizeof(request)) ||
+        !read_all(fd, &response, sizeof(response)) ||
+        !read_all(fd, &stats, sizeof(stats))) {
+        cerr << "Error: cannot read daemon statistics" << endl;
+        return 1;
+    }
+    close(fd);
+
+    cout << "\nDaemon: " << stats.workers << " workers, " << stats.contacts
+         << " contacts, " << stats.requests << " requests in "
+         << stats.batches << " batches (" << stats.superseded
+         << " superseded)\n"
+         << "Queue Depth: " << stats.queue_depth << " (max "
+         << stats.max_queue_depth << ")\n"
+         << "Latency p50/p95/p99: " << stats.latency_p50 * 1e3 << " / "
+         << stats.latency_p95 * 1e3 << " / " << stats.latency_p99 * 1e3
+         << " ms\n"
+         << "Queue Wait p50/p95/p99: " << stats.queue_p50 * 1e3 << " / "
+         << stats.queue_p95 * 1e3 << " / " << stats.queue_p99 * 1e3
+         << " ms" << endl;
+
+    return failures > 0 ? 1 : 0;
+}
@@ -4,9 +4,14 @@
 //#include <hls_math.h>
 #include <cstdint>
 #include <limits>
+#if MULTI_TRACK
+#include <hls_streamofblocks.h>
+#endif
 
 #define ATAN_LUT_SIZE 1024
+#if ATAN2_IMPL != 1
 static float atan_lut[ATAN_LUT_SIZE];
+#endif
 
 // Parameter ranges
 #if DIMENSIONS == 4
@@ -85,13 +90,16 @@ const float parameter_ranges[8][2] = {
 #error "Invalid DIMENSIONS value. Must be 4, 6, or 8."
 #endif
 
+#if ATAN2_IMPL != 1
 void init_atan_lut() {
     for (int i = 0; i < ATAN_LUT_SIZE; i++) {
         float ratio = (float)i / (ATAN_LUT_SIZE - 1); // 0..1
         atan_lut[i] = atan(ratio); // radians
     }
 }
+#endif
 
+#if ATAN2_IMPL == 0
 float fast_atan2(float y, float x) {
     #pragma HLS INLINE
     float abs_y = (y >= 0) ? y : -y;
@@ -119,6 +127,112 @@ float fast_atan2(float y, float x) {
 
     return angle;
 }
+#else
+// Power of two that brings v (> 0) into [1, 2), built from the exponent bits
+// so the scaling is an exact multiply rather than a divide.
+static float normalise_scale(float v) {
+    #pragma HLS INLINE
+    union { float f; uint32_t i; } value, scale;
+    value.f = v;
+    uint32_t exponent = (value.i >> 23) & 0xFF;
+    scale.i = (254u - exponent) << 23;
+    return scale.f;
+}
+
+// Map a first-quadrant angle atan2(|y|, |x|) back to the quadrant of (x, y)
+static float quadrant_correct(float angle, float y, float x) {
+    #pragma HLS INLINE
+    return (x >= 0) ? ((y >= 0) ? angle : -angle)
+                    : ((y >= 0) ? (float)M_PI - angle : -(float)M_PI + angle);
+}
+#endif
+
+#if ATAN2_IMPL == 1
+// atan(2^-i) in Q3.28 radians
+static const int32_t cordic_angles[28] = {
+    210828714, 124459457, 65760959, 33381290, 16755422, 8385879, 4193963,
+    2097109,   1048571,   524287,   262144,   131072,   65536,   32768,
+    16384,     8192,      4096,     2048,     1024,     512,     256,
+    128,       64,        32,       16,       8,        4,       2,
+};
+
+float fast_atan2(float y, float x) {
+    #pragma HLS INLINE
+    float abs_y = (y >= 0) ? y : -y;
+    float abs_x = (x >= 0) ? x : -x;
+    float abs_max = (abs_x > abs_y) ? abs_x : abs_y;
+    if (abs_max == 0.0f) return 0.0f;
+
+    // Normalise the larger component into [1, 2) and convert to Q3.28
+    float scale = normalise_scale(abs_max) * 268435456.0f; // 2^28
+    int32_t xc = (int32_t)(abs_x * scale);
+    int32_t yc = (int32_t)(abs_y * scale);
+    int32_t zc = 0;
+
+    // Vectoring mode: rotate (xc, yc) onto the x axis, accumulating the angle
+loop_cordic:
+    for (int i = 0; i < CORDIC_ITERATIONS; i++) {
+#if CORDIC_UNROLL
+#pragma HLS UNROLL
+#else
+#pragma HLS PIPELINE off
+#endif
+        int32_t xs = xc >> i;
+        int32_t ys = yc >> i;
+        if (yc > 0) {
+            xc += ys;
+            yc -= xs;
+            zc += cordic_angles[i];
+        } else {
+            xc -= ys;
+            yc += xs;
+            zc -= cordic_angles[i];
+        }
+    }
+
+    float angle = (float)zc * (1.0f / 268435456.0f);
+    return quadrant_correct(angle, y, x);
+}
+#elif ATAN2_IMPL == 2
+// 1/m for m in [1, 2): linear seed (max relative error 1/17) refined by three
+// Newton-Raphson steps, r <- r * (2 - m * r), using multiplies only.
+static float reciprocal_nr(float m) {
+    #pragma HLS INLINE
+    float r = 1.411764706f - 0.470588235f * m; // 24/17 - 8/17 m
+    for (int i = 0; i < 3; i++) {
+#pragma HLS UNROLL
+        r = r * (2.0f - m * r);
+    }
+    return r;
+}
+
+float fast_atan2(float y, float x) {
+    #pragma HLS INLINE
+    float abs_y = (y >= 0) ? y : -y;
+    float abs_x = (x >= 0) ? x : -x;
+    bool swap = abs_y > abs_x;
+    float num = swap ? abs_x : abs_y;
+    float den = swap ? abs_y : abs_x;
+    if (den == 0.0f) return 0.0f;
+
+    // ratio = num / den with den normalised into [1, 2)
+    float scale = normalise_scale(den);
+    float ratio = (num * scale) * reciprocal_nr(den * scale);
+    if (ratio > 1.0f) ratio = 1.0f;
+
+    // Linear interpolation between neighbouring LUT entries
+    float pos = ratio * (ATAN_LUT_SIZE - 1);
+    int index = (int)pos;
+    if (index > ATAN_LUT_SIZE - 2) index = ATAN_LUT_SIZE - 2;
+    float frac = pos - (float)index;
+    float lo = atan_lut[index];
+    float hi = atan_lut[index + 1];
+    float angle = lo + frac * (hi - lo);
+
+    if (swap) angle = (float)M_PI_2 - angle;
+    return quadrant_correct(angle, y, x);
+}
+#endif
 
 // // Random number generator (for simplicity, linear congruential generator)
 // float random_float() {
@@ -247,7 +361,7 @@ void read_input_stream(hls::stream<axis_in_t> &in_stream,
                        float ownship_x_arr[MAX_ENTRIES],
                        float ownship_y_arr[MAX_ENTRIES],
                        float measure_arr[MAX_ENTRIES],
-                       int n) {
+                       int n, hls::stream<bool> &ingest_done) {
 #pragma HLS INLINE off
   for (int i = 0; i < n; i++) {
 #pragma HLS PIPELINE II = 1
@@ -276,26 +390,74 @@ void read_input_stream(hls::stream<axis_in_t> &in_stream,
                     << "measure = " << measure);
     }
   }
+  ingest_done.write(true);
 }
 
-void compute_aco_kernel(const float ownship_x_arr[MAX_ENTRIES],
-                        const float ownship_y_arr[MAX_ENTRIES],
-                        const float measure_arr[MAX_ENTRIES],
-                        int n,
-                        hls::stream<float> &best_fitness_out,
-                        hls::stream<float> &best_solution_out) {
-#pragma HLS INLINE off
-  // Initialize atan LUT once
-  init_atan_lut();
+#if PROGRESS_STREAM
+// One progress packet: the track tag (MULTI_TRACK only), iteration, best
+// fitness and, with PROGRESS_SOLUTION, the best solution
+void write_progress(hls::stream<axis_out_t> &progress_stream, uint32_t tag,
+                    int iteration, float best_fitness,
+                    const float current_best_solution[DIMENSIONS]) {
+#pragma HLS INLINE
+  const int head = MULTI_TRACK ? 1 : 0;
+  const int words = head + (PROGRESS_SOLUTION ? DIMENSIONS + 2 : 2);
+
+  for (int i = 0; i < words; i++) {
+#pragma HLS PIPELINE II = 1
+    axis_out_t word;
+    uint32_t data;
+    int field = i - head;
 
-  float best_fitness = 3.4028235e+38f;
-  float current_best_solution[DIMENSIONS];
+    if (field < 0) {
+      data = tag;
+    } else if (field == 0) {
+      data = iteration;
+    } else {
+      float value = (field == 1) ? best_fitness
+                                 : current_best_solution[field - 2];
+      data = *reinterpret_cast<uint32_t*>(&value);
+    }
+
+    word.data = data;
+    word.keep = 0xF;
+    word.last = (i == words - 1);
+    progress_stream.write(word);
+  }
+}
+#endif
+
+// One full ACO run over a single track
+void run_colony(const float ownship_x_arr[MAX_ENTRIES],
+                const float ownship_y_arr[MAX_ENTRIES],
+                const float measure_arr[MAX_ENTRIES],
+                int n, float &best_fitness,
+                float current_best_solution[DIMENSIONS],
+                volatile int *current_iter, volatile float *current_best,
+                volatile int *stop, int max_iterations
+#if PROGRESS_STREAM
+                , hls::stream<axis_out_t> &progress_stream, uint32_t tag
+#endif
+                ) {
+#pragma HLS INLINE
+  best_fitness = 3.4028235e+38f;
   uint64_t random_seed = static_cast<uint64_t>(RANDOM_SEED);
   //unsigned int random_state = RANDOM_SEED;
 
+  // Every run starts from uniform pheromones
+  for (int d = 0; d < DIMENSIONS; d++) {
+#pragma HLS UNROLL
+    pheromones[d] = 1.0f;
+  }
+
+  int iterations = (max_iterations > 0 && max_iterations < ITERATIONS)
+                       ? max_iterations
+                       : ITERATIONS;
+
 loop_iter:
-  for (int iter = 0; iter < ITERATIONS; iter++) {
+  for (int iter = 0; iter < iterations; iter++) {
 #pragma HLS PIPELINE off
+#pragma HLS LOOP_TRIPCOUNT min = 1 max = ITERATIONS
 
     float ants[NUM_ANTS][DIMENSIONS];
     float fitness[NUM_ANTS];
@@ -365,9 +527,55 @@ loop_iter:
       // Update the pheromone
       pheromones[d] = new_pheromone;
     }
-    DEBUG_PRINT("Iteration " << iter + 1 << "/" << ITERATIONS
+    // Progress registers, readable over AXI-Lite while the kernel runs
+    *current_iter = iter + 1;
+    *current_best = best_fitness;
+
+#if PROGRESS_STREAM
+    if ((iter + 1) % PROGRESS_INTERVAL == 0) {
+      write_progress(progress_stream, tag, iter + 1, best_fitness,
+                     current_best_solution);
+    }
+#endif
+
+    DEBUG_PRINT("Iteration " << iter + 1 << "/" << iterations
                              << ", Best Fitness: " << best_fitness);
+
+    // Host abort: leave with the best result found so far
+    if (*stop)
+      break;
   }
+}
+
+void compute_aco_kernel(const float ownship_x_arr[MAX_ENTRIES],
+                        const float ownship_y_arr[MAX_ENTRIES],
+                        const float measure_arr[MAX_ENTRIES],
+                        int n,
+                        hls::stream<float> &best_fitness_out,
+                        hls::stream<float> &best_solution_out,
+                        volatile int *current_iter,
+                        volatile float *current_best, volatile int *stop,
+                        int max_iterations,
+#if PROGRESS_STREAM
+                        hls::stream<axis_out_t> &progress_stream,
+#endif
+                        hls::stream<bool> &compute_done) {
+#pragma HLS INLINE off
+  // Initialize atan LUT once
+#if ATAN2_IMPL != 1
+  init_atan_lut();
+#endif
+
+  float best_fitness;
+  float current_best_solution[DIMENSIONS];
+  run_colony(ownship_x_arr, ownship_y_arr, measure_arr, n, best_fitness,
+             current_best_solution, current_iter, current_best, stop,
+             max_iterations
+#if PROGRESS_STREAM
+             , progress_stream, 0
+#endif
+             );
+  compute_done.write(true);
 
   best_fitness_out.write(best_fitness);
   for (int i = 0; i < DIMENSIONS; i++) {
@@ -384,7 +592,8 @@ loop_iter:
 
 void write_output_stream(hls::stream<float> &best_fitness_in,
                          hls::stream<float> &best_solution_in,
-                         hls::stream<axis_out_t> &out_stream) {
+                         hls::stream<axis_out_t> &out_stream,
+                         hls::stream<bool> &output_done) {
 
   for (int i = 0; i < DIMENSIONS + 1; i++) {
     #pragma HLS PIPELINE II = 1
@@ -413,13 +622,261 @@ void write_output_stream(hls::stream<float> &best_fitness_in,
     // Send over stream
     out_stream.write(word);
   }
+  output_done.write(true);
+}
+
+// Free-running cycle counter alongside the dataflow stages. Each stage posts
+// one token when it finishes; the II=1 loop polls them without blocking, so
+// one loop trip is one clock cycle.
+void perf_monitor(hls::stream<bool> &ingest_done,
+                  hls::stream<bool> &compute_done,
+                  hls::stream<bool> &output_done,
+                  volatile uint64_t *ingest_cycles,
+                  volatile uint64_t *compute_cycles,
+                  volatile uint64_t *output_cycles) {
+#pragma HLS INLINE off
+  uint64_t cycle = 0;
+  uint64_t ingest_end = 0;
+  uint64_t compute_end = 0;
+  bool ingested = false;
+  bool computed = false;
+  bool done = false;
+  bool token;
+
+loop_monitor:
+  while (!done) {
+#pragma HLS PIPELINE II = 1
+    cycle++;
+    if (!ingested && ingest_done.read_nb(token)) {
+      ingested = true;
+      ingest_end = cycle;
+      *ingest_cycles = cycle;
+    }
+    if (ingested && !computed && compute_done.read_nb(token)) {
+      computed = true;
+      compute_end = cycle;
+      *compute_cycles = cycle - ingest_end;
+    }
+    if (computed && output_done.read_nb(token)) {
+      done = true;
+      *output_cycles = cycle - compute_end;
+    }
+  }
+}
+
+#if MULTI_TRACK
+// Track buffer handed from ingest to compute: x, y and measure columns
+typedef float track_buf_t[3][MAX_ENTRIES];
+
+struct track_info_t {
+  uint32_t tag;
+  int n;
+};
+
+void read_track_stream(hls::stream<axis_in_t> &in_stream, int num_tracks,
+                       hls::stream_of_blocks<track_buf_t> &track_blocks,
+                       hls::stream<track_info_t> &info_out,
+                       hls::stream<bool> &ingest_done) {
+#pragma HLS INLINE off
+loop_tracks_in:
+  for (int t = 0; t < num_tracks; t++) {
+    axis_in_t header = in_stream.read();
+    ap_uint<96> header_data = header.data;
+    int n = header_data.range(31, 0);
+    uint32_t tag = header_data.range(63, 32);
+
+    // Fills whichever of the two buffers compute is not holding
+    hls::write_lock<track_buf_t> buf(track_blocks);
+
+    int count = 0;
+    bool last = header.last;
+  loop_samples_in:
+    while (!last) {
+#pragma HLS PIPELINE II = 1
+      axis_in_t input = in_stream.read();
+      ap_uint<96> data = input.data;
+
+      uint32_t raw_x = data.range(31, 0);
+      uint32_t raw_y = data.range(63, 32);
+      uint32_t raw_m = data.range(95, 64);
+
+      if (count < MAX_ENTRIES) {
+        buf[0][count] = *reinterpret_cast<float*>(&raw_x);
+        buf[1][count] = *reinterpret_cast<float*>(&raw_y);
+        buf[2][count] = *reinterpret_cast<float*>(&raw_m);
+      }
+      count++;
+      last = input.last;
+    }
+
+    // Trust the frame, not the header, if they disagree
+    if (count < n) n = count;
+    if (n > MAX_ENTRIES) n = MAX_ENTRIES;
+
+    track_info_t info;
+    info.tag = tag;
+    info.n = n;
+    info_out.write(info);
+
+    DEBUG_PRINT("Track " << tag << ": " << count << " samples received, n = "
+                         << n);
+  }
+  ingest_done.write(true);
+}
+
+void compute_track_stream(hls::stream_of_blocks<track_buf_t> &track_blocks,
+                          hls::stream<track_info_t> &info_in, int num_tracks,
+                          hls::stream<uint32_t> &tag_out,
+                          hls::stream<float> &best_fitness_out,
+                          hls::stream<float> &best_solution_out,
+                          volatile int *current_iter,
+                          volatile float *current_best, volatile int *stop,
+                          int max_iterations,
+#if PROGRESS_STREAM
+                          hls::stream<axis_out_t> &progress_stream,
+#endif
+                          hls::stream<bool> &compute_done) {
+#pragma HLS INLINE off
+#if ATAN2_IMPL != 1
+  init_atan_lut();
+#endif
+
+loop_tracks_compute:
+  for (int t = 0; t < num_tracks; t++) {
+    track_info_t info = info_in.read();
+    hls::read_lock<track_buf_t> buf(track_blocks);
+
+    float best_fitness;
+    float current_best_solution[DIMENSIONS];
+    run_colony(buf[0], buf[1], buf[2], info.n, best_fitness,
+               current_best_solution, current_iter, current_best, stop,
+               max_iterations
+#if PROGRESS_STREAM
+               , progress_stream, info.tag
+#endif
+               );
+
+    tag_out.write(info.tag);
+    best_fitness_out.write(best_fitness);
+    for (int i = 0; i < DIMENSIONS; i++) {
+      best_solution_out.write(current_best_solution[i]);
+    }
+  }
+  compute_done.write(true);
+}
+
+void write_track_stream(hls::stream<uint32_t> &tag_in,
+                        hls::stream<float> &best_fitness_in,
+                        hls::stream<float> &best_solution_in,
+                        hls::stream<axis_out_t> &out_stream, int num_tracks,
+                        hls::stream<bool> &output_done) {
+#pragma HLS INLINE off
+loop_tracks_out:
+  for (int t = 0; t < num_tracks; t++) {
+    for (int i = 0; i < DIMENSIONS + 2; i++) {
+#pragma HLS PIPELINE II = 1
+      axis_out_t word;
+      uint32_t data;
+
+      if (i == 0) {
+        data = tag_in.read();
+      } else {
+        float value = (i == 1) ? best_fitness_in.read()
+                               : best_solution_in.read();
+        data = *reinterpret_cast<uint32_t*>(&value);
+      }
+
+      word.data = data;
+      word.keep = 0xF;
+      word.last = (i == DIMENSIONS + 1); // TLAST closes each track's packet
+      out_stream.write(word);
+    }
+  }
+  output_done.write(true);
 }
 
+void aco(hls::stream<axis_in_t> &in_stream,
+         hls::stream<axis_out_t> &out_stream, int num_tracks,
+         volatile uint64_t *ingest_cycles, volatile uint64_t *compute_cycles,
+         volatile uint64_t *output_cycles, volatile int *current_iter,
+         volatile float *current_best, volatile int *stop, int max_iterations
+#if PROGRESS_STREAM
+         , hls::stream<axis_out_t> &progress_stream
+#endif
+         ) {
+#pragma HLS INTERFACE axis register_mode = both port = in_stream
+#pragma HLS INTERFACE axis register_mode = both port = out_stream
+#pragma HLS INTERFACE s_axilite port = num_tracks
+#pragma HLS INTERFACE s_axilite port = ingest_cycles
+#pragma HLS INTERFACE s_axilite port = compute_cycles
+#pragma HLS INTERFACE s_axilite port = output_cycles
+#pragma HLS INTERFACE s_axilite port = current_iter
+#pragma HLS INTERFACE s_axilite port = current_best
+#pragma HLS INTERFACE s_axilite port = stop
+#pragma HLS INTERFACE s_axilite port = max_iterations
+#if PROGRESS_STREAM
+#pragma HLS INTERFACE axis register_mode = both port = progress_stream
+#endif
+#pragma HLS INTERFACE s_axilite port = return
+#pragma HLS DATAFLOW
+
+  // Two blocks deep: ingest of track k+1 overlaps compute of track k
+  hls::stream_of_blocks<track_buf_t> track_blocks;
+#pragma HLS STREAM variable = track_blocks depth = 2
+
+  hls::stream<track_info_t> track_info_stream("track_info_stream");
+  hls::stream<uint32_t> tag_stream("tag_stream");
+  hls::stream<float> best_fitness_stream("best_fitness_stream");
+  hls::stream<float> best_solution_stream("best_solution_stream");
+
+#pragma HLS STREAM variable = track_info_stream depth = 4
+#pragma HLS STREAM variable = tag_stream depth = 4
+#pragma HLS STREAM variable = best_fitness_stream depth = 4
+#pragma HLS STREAM variable = best_solution_stream depth = 4 * DIMENSIONS
+
+  // Phase-done tokens for the cycle monitor
+  hls::stream<bool> ingest_done("ingest_done");
+  hls::stream<bool> compute_done("compute_done");
+  hls::stream<bool> output_done("output_done");
+
+  read_track_stream(in_stream, num_tracks, track_blocks, track_info_stream,
+                    ingest_done);
+  compute_track_stream(track_blocks, track_info_stream, num_tracks, tag_stream,
+                       best_fitness_stream, best_solution_stream, current_iter,
+                       current_best, stop, max_iterations,
+#if PROGRESS_STREAM
+                       progress_stream,
+#endif
+                       compute_done);
+  write_track_stream(tag_stream, best_fitness_stream, best_solution_stream,
+                     out_stream, num_tracks, output_done);
+  perf_monitor(ingest_done, compute_done, output_done, ingest_cycles,
+               compute_cycles, output_cycles);
+}
+#else
 void aco(hls::stream<axis_in_t> & in_stream,
-           hls::stream<axis_out_t> & out_stream, int n) {
+           hls::stream<axis_out_t> & out_stream, int n,
+           volatile uint64_t *ingest_cycles, volatile uint64_t *compute_cycles,
+           volatile uint64_t *output_cycles, volatile int *current_iter,
+           volatile float *current_best, volatile int *stop,
+           int max_iterations
+#if PROGRESS_STREAM
+           , hls::stream<axis_out_t> &progress_stream
+#endif
+           ) {
 #pragma HLS INTERFACE axis register_mode = both port = in_stream
 #pragma HLS INTERFACE axis register_mode = both port = out_stream
 #pragma HLS INTERFACE s_axilite port = n
+#pragma HLS INTERFACE s_axilite port = ingest_cycles
+#pragma HLS INTERFACE s_axilite port = compute_cycles
+#pragma HLS INTERFACE s_axilite port = output_cycles
+#pragma HLS INTERFACE s_axilite port = current_iter
+#pragma HLS INTERFACE s_axilite port = current_best
+#pragma HLS INTERFACE s_axilite port = stop
+#pragma HLS INTERFACE s_axilite port = max_iterations
+#if PROGRESS_STREAM
+#pragma HLS INTERFACE axis register_mode = both port = progress_stream
+#endif
 #pragma HLS INTERFACE s_axilite port = return
 #pragma HLS DATAFLOW
 
@@ -434,8 +891,23 @@ void aco(hls::stream<axis_in_t> & in_stream,
 #pragma HLS STREAM variable = best_fitness_stream depth = 8
 #pragma HLS STREAM variable = best_solution_stream depth = 8
 
-  read_input_stream(in_stream, ownship_x_arr, ownship_y_arr, measure_arr, n);
+  // Phase-done tokens for the cycle monitor
+  hls::stream<bool> ingest_done("ingest_done");
+  hls::stream<bool> compute_done("compute_done");
+  hls::stream<bool> output_done("output_done");
+
+  read_input_stream(in_stream, ownship_x_arr, ownship_y_arr, measure_arr, n,
+                    ingest_done);
   compute_aco_kernel(ownship_x_arr, ownship_y_arr, measure_arr, n,
-                     best_fitness_stream, best_solution_stream);
-  write_output_stream(best_fitness_stream, best_solution_stream, out_stream);
-}
\ No newline at end of file
+                     best_fitness_stream, best_solution_stream, current_iter,
+                     current_best, stop, max_iterations,
+#if PROGRESS_STREAM
+                     progress_stream,
+#endif
+                     compute_done);
+  write_output_stream(best_fitness_stream, best_solution_stream, out_stream,
+                      output_done);
+  perf_monitor(ingest_done, compute_done, output_done, ingest_cycles,
+               compute_cycles, output_cycles);
+}
+#endif
@@ -3,6 +3,7 @@
 
 #include <ap_axi_sdata.h>
 #include <hls_stream.h>
+#include <cstdint>
 #include <iostream>
 
 #ifdef DEBUG
@@ -43,14 +44,105 @@
 #define SAMPLING_TIME 2 // RNG seed
 #endif
 
+// atan2 implementation used by the objective function:
+//   0 = 1024-entry LUT, nearest entry (float divide)
+//   1 = CORDIC vectoring mode (shift/add only, no divide)
+//   2 = interpolated LUT with Newton-Raphson reciprocal (no divide)
+#ifndef ATAN2_IMPL
+#define ATAN2_IMPL 0
+#endif
+
+#if ATAN2_IMPL != 0 && ATAN2_IMPL != 1 && ATAN2_IMPL != 2
+#error "Invalid ATAN2_IMPL value. Must be 0, 1, or 2."
+#endif
+
+#ifndef CORDIC_ITERATIONS // Micro-rotations for ATAN2_IMPL=1 (max 28)
+#define CORDIC_ITERATIONS 24
+#endif
+
+#if CORDIC_ITERATIONS < 1 || CORDIC_ITERATIONS > 28
+#error "Invalid CORDIC_ITERATIONS value. Must be between 1 and 28."
+#endif
+
+#ifndef CORDIC_UNROLL // 1 = pipelined (one stage per rotation), 0 = iterative
+#define CORDIC_UNROLL 1
+#endif
+
+// Input framing: 0 = one track of n samples per start, 1 = a sequence of
+// num_tracks TLAST-framed tracks per start, ingested while the previous track
+// is being computed
+#ifndef MULTI_TRACK
+#define MULTI_TRACK 0
+#endif
+
+// Progress side stream: 1 = every PROGRESS_INTERVAL iterations, write a
+// packet [iteration, best fitness] (plus the best solution if
+// PROGRESS_SOLUTION=1) with TLAST on its last word to progress_stream. With
+// MULTI_TRACK the packet starts with the track's header tag, as the result
+// packets do.
+#ifndef PROGRESS_STREAM
+#define PROGRESS_STREAM 0
+#endif
+
+#ifndef PROGRESS_INTERVAL
+#define PROGRESS_INTERVAL 50
+#endif
+
+#ifndef PROGRESS_SOLUTION
+#define PROGRESS_SOLUTION 0
+#endif
+
+#if PROGRESS_INTERVAL < 1
+#error "Invalid PROGRESS_INTERVAL value. Must be at least 1."
+#endif
+
 // AXI Stream data type (32-bit for output, 96-bit for input)
 typedef ap_axiu<96, 1, 1, 1> axis_in_t;
 typedef ap_axiu<32, 1, 1, 1> axis_out_t;
 
+// AXI-Lite status registers (outputs):
+//   ingest_cycles, compute_cycles, output_cycles - length of each phase in
+//       kernel clock cycles, counted by a monitor process that runs alongside
+//       the dataflow stages (valid in cosim and on the board; csim has no
+//       clock and reports placeholder values). With MULTI_TRACK the phases
+//       overlap, so they are the spans from start until all tracks are
+//       ingested, from there until all are computed, and from there until the
+//       last result is written.
+//   current_iter, current_best - updated every iteration, so they can be
+//       polled while the kernel runs
+// AXI-Lite control registers (inputs):
+//   stop - checked at the end of every iteration; when non-zero the run ends
+//       and writes its best result so far (with MULTI_TRACK, every remaining
+//       track then stops after one iteration). Clear it before the next start.
+//   max_iterations - iteration budget per track, 0 or > ITERATIONS means
+//       ITERATIONS
 extern "C" {
 
+#if MULTI_TRACK
+// Each input track is a header word (bits 31:0 = n, bits 63:32 = tag)
+// followed by its sample words, with TLAST on the last sample word. Each track
+// produces one result packet: tag, best fitness, best solution[DIMENSIONS],
+// with TLAST on the last word.
+void aco(hls::stream<axis_in_t> &in_stream,
+         hls::stream<axis_out_t> &out_stream, int num_tracks,
+         volatile uint64_t *ingest_cycles, volatile uint64_t *compute_cycles,
+         volatile uint64_t *output_cycles, volatile int *current_iter,
+         volatile float *current_best, volatile int *stop, int max_iterations
+#if PROGRESS_STREAM
+         , hls::stream<axis_out_t> &progress_stream
+#endif
+         );
+#else
 void aco(hls::stream<axis_in_t> &in_stream, 
-         hls::stream<axis_out_t> &out_stream, int n);
+         hls::stream<axis_out_t> &out_stream, int n,
+         volatile uint64_t *ingest_cycles, volatile uint64_t *compute_cycles,
+         volatile uint64_t *output_cycles, volatile int *current_iter,
+         volatile float *current_best, volatile int *stop, int max_iterations
+#if PROGRESS_STREAM
+         , hls::stream<axis_out_t> &progress_stream
+#endif
+         );
+#endif
 }
 
 #endif // ACO_H
@@ -1,5 +1,6 @@
 #include "aco.h"
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <sstream>
@@ -7,12 +8,18 @@
 
 using namespace std;
 
+#ifndef TB_MAX_ITERATIONS // max_iterations register value, 0 = ITERATIONS
+#define TB_MAX_ITERATIONS 0
+#endif
+
 // AXI Stream data type (32-bit for output, 96-bit for input)
 typedef ap_axiu<96, 1, 1, 1> axis_in_t;
 typedef ap_axiu<32, 1, 1, 1> axis_out_t;
 
-// Load input data from CSV file into in_stream (packed)
-void load_data(const char *file_path, hls::stream<axis_in_t> &in_stream) {
+// Load input data from CSV file into in_stream (packed). A non-negative tag
+// prefixes the samples with a MULTI_TRACK header word carrying n and the tag.
+void load_data(const char *file_path, hls::stream<axis_in_t> &in_stream,
+               int tag = -1) {
   ifstream infile(file_path);
   if (!infile) {
     cerr << "Error: Unable to open input file: " << file_path << endl;
@@ -37,6 +44,15 @@ void load_data(const char *file_path, hls::stream<axis_in_t> &in_stream) {
   infile.seekg(0, ios::beg);
   getline(infile, line); // skip header again
 
+  if (tag >= 0) {
+    axis_in_t header_word;
+    header_word.data = ((ap_uint<96>)(uint32_t)tag << 32) |
+                       ((ap_uint<96>)(uint32_t)num_lines);
+    header_word.last = (num_lines == 0) ? 1 : 0;
+    header_word.keep = 0xFFF;
+    in_stream.write(header_word);
+  }
+
   int i = 0;
   while (getline(infile, line)) {
     stringstream ss(line);
@@ -98,16 +114,50 @@ void display_results(hls::stream<axis_out_t> &out_stream) {
       break;
   }
 
-  // Ensure the stream is fully consumed before exiting
-  while (!out_stream.empty()) {
-    out_stream.read(); // Drain any leftover words
+  cout << "\n";
+}
+
+#ifdef ATAN2_CHARACTERISE
+void init_atan_lut();
+float fast_atan2(float y, float x);
+
+// Sweep the selected fast_atan2 over the full circle at several magnitudes and
+// report the worst-case and RMS angular error against atan2f
+void characterise_atan2() {
+#if ATAN2_IMPL != 1
+  init_atan_lut();
+#endif
+  const int steps = 100000;
+  const float radii[] = {1e-3f, 1.0f, 1e3f, 3e4f, 5e6f};
+  double max_err = 0.0, sum_sq = 0.0;
+  int count = 0;
+
+  for (float r : radii) {
+    for (int k = 0; k < steps; k++) {
+      double a = -M_PI + (2.0 * M_PI * k) / steps;
+      float x = (float)(r * cos(a));
+      float y = (float)(r * sin(a));
+      double err = fabs((double)fast_atan2(y, x) - (double)atan2f(y, x));
+      if (err > M_PI) err = 2.0 * M_PI - err; // same direction across +/-pi
+      if (err > max_err) max_err = err;
+      sum_sq += err * err;
+      count++;
+    }
   }
 
-  cout << "\n";
+  cout << "atan2 characterisation (ATAN2_IMPL=" << ATAN2_IMPL << "): "
+       << "max error " << scientific << max_err << " rad, RMS error "
+       << sqrt(sum_sq / count) << " rad over " << count << " points"
+       << defaultfloat << endl;
 }
+#endif
 
 // Main testbench function
 int main(int argc, char **argv) {
+#ifdef ATAN2_CHARACTERISE
+  characterise_atan2();
+#endif
+
   if (argc < 2) {
     cerr << "usage: filename.csv>\n" << argv[0];
     return 1;
@@ -117,14 +167,41 @@ int main(int argc, char **argv) {
   hls::stream<axis_out_t> out_stream;
 
   // Load input data into in_stream
+#if MULTI_TRACK
+  int num_tracks = argc - 1; // every CSV argument is one track
+  for (int t = 0; t < num_tracks; t++) {
+    load_data(argv[t + 1], in_stream, t);
+  }
+#else
   load_data(argv[1], in_stream);
+#endif
 
   // Start timing
   auto start_time = chrono::high_resolution_clock::now();
 
+  // Status and control registers
+  uint64_t ingest_cycles = 0, compute_cycles = 0, output_cycles = 0;
+  int current_iter = 0;
+  float current_best = 0.0f;
+  int stop = 0;
+  int max_iterations = TB_MAX_ITERATIONS;
+#if PROGRESS_STREAM
+  hls::stream<axis_out_t> progress_stream;
+#endif
+
   // Run ACO routine
   cout << "\nRunning ACO minimisation...\n";
-  aco(in_stream, out_stream, MAX_ENTRIES);
+#if MULTI_TRACK
+  aco(in_stream, out_stream, num_tracks, &ingest_cycles, &compute_cycles,
+      &output_cycles, &current_iter, &current_best, &stop, max_iterations
+#else
+  aco(in_stream, out_stream, MAX_ENTRIES, &ingest_cycles, &compute_cycles,
+      &output_cycles, &current_iter, &current_best, &stop, max_iterations
+#endif
+#if PROGRESS_STREAM
+      , progress_stream
+#endif
+      );
 
   // Stop timing
   auto end_time = chrono::high_resolution_clock::now();
@@ -132,10 +209,51 @@ int main(int argc, char **argv) {
       chrono::duration_cast<chrono::duration<double>>(end_time - start_time)
           .count();
 
+#if PROGRESS_STREAM
+  // Progress packets: [track tag,] iteration, best fitness[, best solution]
+  while (!progress_stream.empty()) {
+#if MULTI_TRACK
+    uint32_t tag = progress_stream.read().data;
+    cout << "Progress: Track " << tag << ", ";
+#else
+    cout << "Progress: ";
+#endif
+    uint32_t iteration = progress_stream.read().data;
+    uint32_t bits = progress_stream.read().data;
+    cout << "Iteration " << iteration
+         << ", Best Fitness: " << *reinterpret_cast<float *>(&bits);
+#if PROGRESS_SOLUTION
+    cout << ", Best Solution:";
+    for (int i = 0; i < DIMENSIONS; i++) {
+      bits = progress_stream.read().data;
+      cout << " " << *reinterpret_cast<float *>(&bits);
+    }
+#endif
+    cout << "\n";
+  }
+#endif
+
   // Print results
+#if MULTI_TRACK
+  for (int t = 0; t < num_tracks; t++) {
+    uint32_t tag = out_stream.read().data;
+    cout << "Track " << tag << ": " << argv[tag + 1] << "\n";
+    display_results(out_stream);
+  }
+#else
   display_results(out_stream);
+#endif
+  cout << "Iterations: " << current_iter << ", Last Best Fitness: "
+       << current_best << "\n";
+  // Cycle counts are only meaningful in cosim and on the board
+  cout << "Cycles (ingest/compute/output): " << ingest_cycles << " / "
+       << compute_cycles << " / " << output_cycles << "\n";
   cout << "Elapsed Time: " << elapsed << " seconds" << endl;
 
+  // Ensure the stream is fully consumed before exiting
+  while (!out_stream.empty())
+    out_stream.read(); // Drain any leftover words
+
   while (!in_stream.empty())
     in_stream.read(); // Drain remaining
 
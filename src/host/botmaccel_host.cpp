@@ -0,0 +1,184 @@
+#include "botmaccel_host.h"
+#include "aco.h"
+#include <cstring>
+
+using namespace std;
+
+size_t dma_bytes_per_sample(dma_layout layout, int buffer) {
+    if (layout == dma_layout::single) {
+        return (buffer == 0) ? 16 : 0;
+    }
+    return (buffer == 0) ? 8 : 4;
+}
+
+static inline uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+void pack_track(dma_layout layout, const track_view &track,
+                dma_buffer buffers[2]) {
+    if (layout == dma_layout::single) {
+        uint32_t *words = static_cast<uint32_t *>(buffers[0].data);
+        for (int i = 0; i < track.n; i++) {
+            words[4 * i + 0] = float_bits(track.ownship_x[i]);
+            words[4 * i + 1] = float_bits(track.ownship_y[i]);
+            words[4 * i + 2] = float_bits(track.measure[i]);
+            words[4 * i + 3] = 0;
+        }
+    } else {
+        uint32_t *xy = static_cast<uint32_t *>(buffers[0].data);
+        uint32_t *m = static_cast<uint32_t *>(buffers[1].data);
+        for (int i = 0; i < track.n; i++) {
+            xy[2 * i + 0] = float_bits(track.ownship_x[i]);
+            xy[2 * i + 1] = float_bits(track.ownship_y[i]);
+            m[i] = float_bits(track.measure[i]);
+        }
+    }
+}
+
+host_driver::host_driver(backend &device, dma_layout layout)
+    : device(device), layout(layout) {
+    worker = thread(&host_driver::worker_loop, this);
+}
+
+host_driver::~host_driver() {
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    worker.join();
+
+    for (int b = 0; b < 2; b++) {
+        for (dma_buffer &buffer : free_buffers[b]) {
+            device.free(buffer);
+        }
+    }
+}
+
+// Reuse a pooled buffer large enough for n samples, else allocate one.
+// Called with the mutex held.
+void host_driver::acquire_buffers(int n, dma_buffer buffers[2]) {
+    for (int b = 0; b < 2; b++) {
+        size_t bytes = dma_bytes_per_sample(layout, b) * n;
+        buffers[b] = dma_buffer();
+        if (bytes == 0)
+            continue;
+
+        vector<dma_buffer> &pool = free_buffers[b];
+        for (size_t i = 0; i < pool.size(); i++) {
+            if (pool[i].size >= bytes) {
+                buffers[b] = pool[i];
+                pool.erase(pool.begin() + i);
+                break;
+            }
+        }
+        if (!buffers[b].data) {
+            buffers[b] = device.alloc(bytes);
+        }
+    }
+}
+
+// Called with the mutex held
+void host_driver::release_buffers(dma_buffer buffers[2]) {
+    for (int b = 0; b < 2; b++) {
+        if (buffers[b].data) {
+            free_buffers[b].push_back(buffers[b]);
+        }
+    }
+}
+
+uint64_t host_driver::submit(const track_view &track,
+                             completion_callback callback) {
+    // The device has no bounds check of its own: a larger n overruns its
+    // sample buffers
+    if (track.n <= 0 || track.n > MAX_ENTRIES)
+        return HOST_JOB_REJECTED;
+
+    job new_job;
+    new_job.n = track.n;
+    new_job.callback = move(callback);
+
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        new_job.id = next_id++;
+        acquire_buffers(track.n, new_job.buffers);
+    }
+
+    // Pack outside the lock, straight into the DMA buffers
+    auto pack_start = chrono::steady_clock::now();
+    pack_track(layout, track, new_job.buffers);
+    auto pack_end = chrono::steady_clock::now();
+    new_job.pack_seconds =
+        chrono::duration<double>(pack_end - pack_start).count();
+    new_job.submitted = pack_end;
+
+    uint64_t id = new_job.id;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        jobs.push_back(move(new_job));
+        in_flight++;
+    }
+    work_ready.notify_one();
+    return id;
+}
+
+void host_driver::wait_all() {
+    unique_lock<mutex> lock(queue_mutex);
+    work_done.wait(lock, [this] { return in_flight == 0; });
+}
+
+size_t host_driver::pending() {
+    lock_guard<mutex> lock(queue_mutex);
+    return in_flight;
+}
+
+void host_driver::worker_loop() {
+    for (;;) {
+        job current;
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            work_ready.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return; // stopping and drained
+            current = move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job_result result;
+        result.id = current.id;
+        result.pack_seconds = current.pack_seconds;
+
+        auto device_start = chrono::steady_clock::now();
+        vector<float> words;
+        device.run(layout, current.buffers, current.n, words,
+                   result.counters);
+        auto device_end = chrono::steady_clock::now();
+
+        result.queue_seconds =
+            chrono::duration<double>(device_start - current.submitted).count();
+        result.device_seconds =
+            chrono::duration<double>(device_end - device_start).count();
+        result.best_fitness = words.empty() ? 0.0f : words[0];
+        if (words.size() > 1) {
+            result.best_solution.assign(words.begin() + 1, words.end());
+        }
+
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            release_buffers(current.buffers);
+        }
+
+        if (current.callback) {
+            current.callback(result);
+        }
+
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            in_flight--;
+        }
+        work_done.notify_all();
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef BOTMACCEL_HOST_H
+#define BOTMACCEL_HOST_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define HOST_JOB_REJECTED UINT64_MAX // submit() result for an invalid track
+
+// DMA input layouts of the accelerator designs
+//   single: one 128-bit beat per sample, words [x, y, measure, unused]
+//   dual:   64-bit beats [x, y] on DMA 0 and 32-bit beats [measure] on DMA 1
+enum class dma_layout { single, dual };
+
+// Contiguous, DMA-capable memory owned by a backend
+struct dma_buffer {
+    void *data = nullptr;
+    size_t size = 0;     // bytes
+    uint64_t phys = 0;   // physical address, 0 if not applicable
+};
+
+// Caller-owned track columns; only read during host_driver::submit()
+struct track_view {
+    const float *ownship_x;
+    const float *ownship_y;
+    const float *measure;
+    int n;
+};
+
+// Bytes per sample in each DMA buffer of a layout
+size_t dma_bytes_per_sample(dma_layout layout, int buffer);
+
+// Pack a track straight into the DMA buffers of the given layout. buffers[1]
+// is only used by the dual layout.
+void pack_track(dma_layout layout, const track_view &track,
+                dma_buffer buffers[2]);
+
+// AXI-Lite status registers of the IP, read back after a run. cycles_valid
+// is false when the backend has no clock to count, and the cycle fields are
+// then meaningless.
+struct device_counters {
+    uint64_t ingest_cycles = 0;
+    uint64_t compute_cycles = 0;
+    uint64_t output_cycles = 0;
+    bool cycles_valid = true;
+    int iterations = 0;
+};
+
+struct job_result {
+    uint64_t id;
+    float best_fitness;
+    std::vector<float> best_solution;
+    double pack_seconds;   // caller thread, inside submit()
+    double queue_seconds;  // submit() return to device start
+    double device_seconds; // backend run
+    device_counters counters;
+};
+
+// A device that consumes packed DMA buffers and returns the result words
+// (best fitness followed by the best solution) and its status registers
+class backend {
+  public:
+    virtual ~backend() {}
+    virtual dma_buffer alloc(size_t bytes) = 0;
+    virtual void free(dma_buffer &buffer) = 0;
+    virtual void run(dma_layout layout, const dma_buffer buffers[2], int n,
+                     std::vector<float> &result,
+                     device_counters &counters) = 0;
+};
+
+// Local stand-in built from the HLS C model (src/hls/aco.cpp)
+class software_backend : public backend {
+  public:
+    dma_buffer alloc(size_t bytes) override;
+    void free(dma_buffer &buffer) override;
+    void run(dma_layout layout, const dma_buffer buffers[2], int n,
+             std::vector<float> &result, device_counters &counters) override;
+};
+
+typedef std::function<void(const job_result &)> completion_callback;
+
+// Asynchronous submit/complete queue in front of one backend. Jobs run in
+// submission order on a worker thread; callbacks fire on that thread.
+class host_driver {
+  public:
+    host_driver(backend &device, dma_layout layout);
+    ~host_driver();
+
+    // Queue a track and return its job id, or HOST_JOB_REJECTED (callback not
+    // called) unless 1 <= track.n <= MAX_ENTRIES, the size of the IP's
+    // sample buffers
+    uint64_t submit(const track_view &track, completion_callback callback);
+    void wait_all();
+    size_t pending();
+
+  private:
+    struct job {
+        uint64_t id;
+        int n;
+        dma_buffer buffers[2];
+        completion_callback callback;
+        double pack_seconds;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    void worker_loop();
+    void acquire_buffers(int n, dma_buffer buffers[2]);
+    void release_buffers(dma_buffer buffers[2]);
+
+    backend &device;
+    dma_layout layout;
+
+    std::mutex queue_mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    std::deque<job> jobs;
+    std::vector<dma_buffer> free_buffers[2]; // recycled between jobs
+    size_t in_flight = 0;
+    uint64_t next_id = 0;
+    bool stopping = false;
+    std::thread worker;
+};
+
+#endif // BOTMACCEL_HOST_H
@@ -0,0 +1,46 @@
+#include "aco.h"
+#include "botmaccel_host.h"
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Driver checks that need no input data: tracks the device cannot hold are
+// rejected before any buffer is packed, and a valid track still completes.
+int main() {
+    software_backend device;
+    host_driver driver(device, dma_layout::single);
+    int failures = 0;
+    int completed = 0;
+
+    vector<float> x(MAX_ENTRIES + 1, 0.0f), y(MAX_ENTRIES + 1, 0.0f),
+        measure(MAX_ENTRIES + 1, 0.0f);
+    auto on_done = [&](const job_result &) { completed++; };
+
+    const int rejected_sizes[] = {0, -1, MAX_ENTRIES + 1};
+    for (int n : rejected_sizes) {
+        track_view view = {x.data(), y.data(), measure.data(), n};
+        if (driver.submit(view, on_done) != HOST_JOB_REJECTED) {
+            cerr << "FAIL: track of " << n << " samples was accepted\n";
+            failures++;
+        }
+    }
+
+    // A short track with a constant bearing
+    for (int i = 0; i < 16; i++)
+        measure[i] = 0.785398f;
+    track_view view = {x.data(), y.data(), measure.data(), 16};
+    if (driver.submit(view, on_done) == HOST_JOB_REJECTED) {
+        cerr << "FAIL: track of 16 samples was rejected\n";
+        failures++;
+    }
+    driver.wait_all();
+
+    if (completed != 1) {
+        cerr << "FAIL: " << completed << " jobs completed, expected 1\n";
+        failures++;
+    }
+
+    cout << (failures ? "host_check failed" : "host_check passed") << endl;
+    return failures ? 1 : 0;
+}
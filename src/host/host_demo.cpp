@@ -0,0 +1,132 @@
+#include "aco.h"
+#include "botmaccel_host.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct track_columns {
+    string path;
+    vector<float> ownship_x;
+    vector<float> ownship_y;
+    vector<float> measure;
+};
+
+bool load_data(const char *file_path, track_columns &track) {
+    ifstream file(file_path);
+    if (!file) {
+        cerr << "Error: Unable to open input file: " << file_path << endl;
+        return false;
+    }
+
+    string line;
+    getline(file, line); // header
+
+    track.path = file_path;
+    while (getline(file, line)) {
+        if (line.empty())
+            continue;
+        stringstream ss(line);
+        float timeframe, ownship_x, ownship_y, measure;
+        char comma;
+        ss >> timeframe >> comma >> ownship_x >> comma >> ownship_y >> comma >>
+            measure;
+        track.ownship_x.push_back(ownship_x);
+        track.ownship_y.push_back(ownship_y);
+        track.measure.push_back(measure);
+    }
+    return !track.measure.empty();
+}
+
+int main(int argc, char *argv[]) {
+    dma_layout layout = dma_layout::single;
+    int repeat = 1;
+    vector<track_columns> tracks;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dual") == 0) {
+            layout = dma_layout::dual;
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else {
+            track_columns track;
+            if (!load_data(argv[i], track))
+                return 1;
+            tracks.push_back(move(track));
+        }
+    }
+
+    if (tracks.empty() || repeat < 1) {
+        cerr << "Usage: " << argv[0]
+             << " [--dual] [--repeat N] <input1.csv> [input2.csv ...]\n";
+        return 1;
+    }
+
+    software_backend device;
+    host_driver driver(device, layout);
+
+    double pack_total = 0.0, queue_total = 0.0, device_total = 0.0;
+    double ingest_total = 0.0, compute_total = 0.0, output_total = 0.0;
+    bool cycles_valid = true;
+    int completed = 0;
+    mutex print_mutex;
+
+    auto start_time = chrono::steady_clock::now();
+    for (int r = 0; r < repeat; r++) {
+        for (const track_columns &track : tracks) {
+            track_view view = {track.ownship_x.data(), track.ownship_y.data(),
+                               track.measure.data(),
+                               static_cast<int>(track.measure.size())};
+            const string &path = track.path;
+            uint64_t id =
+                driver.submit(view, [&, path](const job_result &result) {
+                    lock_guard<mutex> lock(print_mutex);
+                    cout << "Job " << result.id << ": " << path << "\n";
+                    cout << "Best Fitness: " << result.best_fitness << "\n";
+                    cout << "Best Solution: ";
+                    for (float value : result.best_solution)
+                        cout << value << " ";
+                    cout << "\n";
+                    pack_total += result.pack_seconds;
+                    queue_total += result.queue_seconds;
+                    device_total += result.device_seconds;
+                    ingest_total += result.counters.ingest_cycles;
+                    compute_total += result.counters.compute_cycles;
+                    output_total += result.counters.output_cycles;
+                    cycles_valid = cycles_valid && result.counters.cycles_valid;
+                    completed++;
+                });
+            if (id == HOST_JOB_REJECTED) {
+                lock_guard<mutex> lock(print_mutex);
+                cerr << "Rejected " << path << ": " << view.n
+                     << " samples, the device takes 1 to " << MAX_ENTRIES
+                     << "\n";
+            }
+        }
+    }
+    driver.wait_all();
+    auto end_time = chrono::steady_clock::now();
+    if (completed == 0)
+        return 1;
+
+    double elapsed = chrono::duration<double>(end_time - start_time).count();
+    cout << "Jobs: " << completed << "\n";
+    cout << "Mean Pack Time: " << pack_total / completed << " seconds\n";
+    cout << "Mean Queue Time: " << queue_total / completed << " seconds\n";
+    cout << "Mean Device Time: " << device_total / completed << " seconds\n";
+    if (cycles_valid)
+        cout << "Mean Cycles (ingest/compute/output): "
+             << ingest_total / completed << " / " << compute_total / completed
+             << " / " << output_total / completed << "\n";
+    else
+        cout << "Mean Cycles (ingest/compute/output): n/a\n";
+    cout << "Elapsed Time: " << elapsed << " seconds" << endl;
+
+    return 0;
+}
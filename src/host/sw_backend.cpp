@@ -0,0 +1,98 @@
+#include "aco.h"
+#include "botmaccel_host.h"
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+dma_buffer software_backend::alloc(size_t bytes) {
+    dma_buffer buffer;
+    size_t rounded = (bytes + 63) & ~static_cast<size_t>(63);
+    buffer.data = aligned_alloc(64, rounded);
+    buffer.size = buffer.data ? bytes : 0;
+    return buffer;
+}
+
+void software_backend::free(dma_buffer &buffer) {
+    std::free(buffer.data);
+    buffer = dma_buffer();
+}
+
+// Replays the packed DMA buffers as the AXI stream the IP would see and runs
+// the HLS C model on them
+void software_backend::run(dma_layout layout, const dma_buffer buffers[2],
+                           int n, vector<float> &result,
+                           device_counters &counters) {
+    hls::stream<axis_in_t> in_stream;
+    hls::stream<axis_out_t> out_stream;
+
+#if MULTI_TRACK
+    axis_in_t header_word;
+    header_word.data = (ap_uint<96>)(uint32_t)n;
+    header_word.keep = 0xFFF;
+    header_word.last = (n == 0) ? 1 : 0;
+    in_stream.write(header_word);
+#endif
+
+    for (int i = 0; i < n; i++) {
+        uint32_t x, y, m;
+        if (layout == dma_layout::single) {
+            const uint32_t *words = static_cast<const uint32_t *>(buffers[0].data);
+            x = words[4 * i + 0];
+            y = words[4 * i + 1];
+            m = words[4 * i + 2];
+        } else {
+            const uint32_t *xy = static_cast<const uint32_t *>(buffers[0].data);
+            const uint32_t *ms = static_cast<const uint32_t *>(buffers[1].data);
+            x = xy[2 * i + 0];
+            y = xy[2 * i + 1];
+            m = ms[i];
+        }
+
+        axis_in_t input_word;
+        input_word.data = ((ap_uint<96>)m << 64) | ((ap_uint<96>)y << 32) |
+                          ((ap_uint<96>)x);
+        input_word.keep = 0xFFF;
+        input_word.last = (i == n - 1) ? 1 : 0;
+        in_stream.write(input_word);
+    }
+
+    // The C model has no clock, so the cycle registers are not reported
+    uint64_t ingest_cycles = 0, compute_cycles = 0, output_cycles = 0;
+    int current_iter = 0;
+    float current_best = 0.0f;
+    int stop = 0;
+#if PROGRESS_STREAM
+    hls::stream<axis_out_t> progress_stream; // not consumed by the driver
+#endif
+#if MULTI_TRACK
+    aco(in_stream, out_stream, 1, &ingest_cycles, &compute_cycles,
+        &output_cycles, &current_iter, &current_best, &stop, 0
+#else
+    aco(in_stream, out_stream, n, &ingest_cycles, &compute_cycles,
+        &output_cycles, &current_iter, &current_best, &stop, 0
+#endif
+#if PROGRESS_STREAM
+        , progress_stream
+#endif
+        );
+#if MULTI_TRACK
+    out_stream.read(); // tag
+#endif
+    counters.ingest_cycles = 0;
+    counters.compute_cycles = 0;
+    counters.output_cycles = 0;
+    counters.cycles_valid = false;
+    counters.iterations = current_iter;
+
+    result.clear();
+    while (!out_stream.empty()) {
+        axis_out_t word = out_stream.read();
+        uint32_t bits = word.data;
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        result.push_back(value);
+        if (word.last)
+            break;
+    }
+}
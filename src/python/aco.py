@@ -2,6 +2,7 @@ import numpy as np
 import pandas as pd
 import time
 import argparse
+import importlib
 
 # Constants
 NUM_ANTS = 20  # Number of ants
@@ -20,6 +21,8 @@ parser.add_argument('--numvars', action="store", dest='numvars', type=int, choic
 parser.add_argument('--csv', action="store", dest='csv_file', required=True, help="Path to the input CSV file")
 parser.add_argument('--param_set', action="store", dest='param_set', type=int, choices=[0, 1], default=0,
                     help="Choose parameter set: 0 = near-linear, 1 = polynomial")
+parser.add_argument('--native', action="store_true", dest='native',
+                    help="Run the C++ solver through the aco_native extension (see build_native.sh)")
 
 # Parse the command line arguments and store the values in the `args` variable
 args = parser.parse_args()
@@ -139,12 +142,29 @@ def aco():
 
     return best_solution, best_fitness
 
+# C++ ACO routine through the aco_native extension module
+def native_aco():
+    module_name = f"aco_native_d{args.numvars}_p{args.param_set}"
+    try:
+        native = importlib.import_module(module_name)
+    except ImportError:
+        raise SystemExit(f"Native module {module_name} not found, build it with ./build_native.sh")
+
+    # float32 contiguous columns are handed to the solver without a copy
+    x = np.ascontiguousarray(ownship_x, dtype=np.float32)
+    y = np.ascontiguousarray(ownship_y, dtype=np.float32)
+    m = np.ascontiguousarray(measure, dtype=np.float32)
+    t = np.ascontiguousarray(timeframe, dtype=np.float32)
+
+    best_fitness, best_solution = native.solve(x, y, m, t, seed=int(args.seed))
+    return best_solution, best_fitness
+
 # Load data
 load_data(args.csv_file)
 
 # Run ACO routine
 start_time = time.time()
-best_solution, best_fitness = aco()
+best_solution, best_fitness = native_aco() if args.native else aco()
 end_time = time.time()
 
 # Print results
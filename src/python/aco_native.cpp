@@ -0,0 +1,186 @@
+// pybind11 bindings for the C++ ACO solver (src/cpp/aco.cpp).
+// DIMENSIONS and PARAM_SET are fixed per build, so build_native.sh compiles
+// one module per combination, named aco_native_d<DIMENSIONS>_p<PARAM_SET>.
+#include "../cpp/aco.h"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef ACO_MODULE
+#define ACO_MODULE aco_native
+#endif
+
+namespace py = pybind11;
+
+// float32 C-contiguous arrays are passed through without a copy; anything
+// else is converted once on the way in
+typedef py::array_t<float, py::array::c_style | py::array::forcecast>
+    float_array;
+
+struct solve_job {
+    const float *ownship_x;
+    const float *ownship_y;
+    const float *measure;
+    int n;
+    const basis_table *basis;
+    unsigned int seed;
+    float best_fitness;
+    float best_solution[DIMENSIONS];
+};
+
+static int column_length(const float_array &ownship_x,
+                         const float_array &ownship_y,
+                         const float_array &measure,
+                         const float_array &timeframe) {
+    if (ownship_x.ndim() != 1 || ownship_y.ndim() != 1 ||
+        measure.ndim() != 1 || timeframe.ndim() != 1)
+        throw std::invalid_argument("columns must be one-dimensional");
+    if (ownship_x.shape(0) != ownship_y.shape(0) ||
+        ownship_x.shape(0) != measure.shape(0) ||
+        ownship_x.shape(0) != timeframe.shape(0))
+        throw std::invalid_argument("columns must have the same length");
+    if (ownship_x.shape(0) == 0)
+        throw std::invalid_argument("columns must not be empty");
+    if (ownship_x.shape(0) > MAX_ENTRIES)
+        throw std::invalid_argument("track longer than MAX_ENTRIES samples");
+    return static_cast<int>(ownship_x.shape(0));
+}
+
+// Basis tables are large (DIMENSIONS / 2 * MAX_ENTRIES floats), so they live
+// on the heap and are shared by every job on the same track
+typedef std::vector<std::unique_ptr<basis_table>> basis_list;
+
+static const basis_table *add_basis(basis_list &tables,
+                                    const float_array &timeframe, int n) {
+    tables.emplace_back(new basis_table);
+    build_basis(timeframe.data(), n, *tables.back());
+    return tables.back().get();
+}
+
+// Solve every job on up to `threads` worker threads (0 = all cores)
+static void run_jobs(std::vector<solve_job> &jobs, int threads) {
+    int workers = threads > 0 ? threads
+                              : static_cast<int>(std::thread::hardware_concurrency());
+    workers = std::max(1, std::min(workers, static_cast<int>(jobs.size())));
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            solve_job &job = jobs[i];
+            unsigned int random_state = job.seed;
+            aco(job.ownship_x, job.ownship_y, job.measure, *job.basis,
+                job.best_fitness, job.best_solution, job.n, random_state);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; t++)
+        pool.emplace_back(worker);
+    worker();
+    for (std::thread &t : pool)
+        t.join();
+}
+
+static py::tuple job_result(const solve_job &job) {
+    py::array_t<float> solution(DIMENSIONS);
+    std::copy(job.best_solution, job.best_solution + DIMENSIONS,
+              solution.mutable_data());
+    return py::make_tuple(job.best_fitness, solution);
+}
+
+static py::list run_and_collect(std::vector<solve_job> &jobs, int threads) {
+    {
+        py::gil_scoped_release release;
+        run_jobs(jobs, threads);
+    }
+    py::list results;
+    for (const solve_job &job : jobs)
+        results.append(job_result(job));
+    return results;
+}
+
+static py::tuple solve(float_array ownship_x, float_array ownship_y,
+                       float_array measure, float_array timeframe,
+                       unsigned int seed) {
+    int n = column_length(ownship_x, ownship_y, measure, timeframe);
+    basis_list tables;
+    std::vector<solve_job> jobs(1);
+    jobs[0] = {ownship_x.data(), ownship_y.data(), measure.data(), n,
+               add_basis(tables, timeframe, n), seed};
+    return run_and_collect(jobs, 1)[0].cast<py::tuple>();
+}
+
+static py::list solve_seeds(float_array ownship_x, float_array ownship_y,
+                            float_array measure, float_array timeframe,
+                            const std::vector<unsigned int> &seeds,
+                            int threads) {
+    int n = column_length(ownship_x, ownship_y, measure, timeframe);
+    basis_list tables;
+    const basis_table *basis = add_basis(tables, timeframe, n);
+    std::vector<solve_job> jobs;
+    for (unsigned int seed : seeds) {
+        jobs.push_back({ownship_x.data(), ownship_y.data(), measure.data(), n,
+                        basis, seed});
+    }
+    if (jobs.empty())
+        return py::list();
+    return run_and_collect(jobs, threads);
+}
+
+// tracks: sequence of (ownship_x, ownship_y, measure, timeframe)
+static py::list solve_tracks(py::sequence tracks, unsigned int seed,
+                             int threads) {
+    // Hold the (possibly converted) arrays for the duration of the solve
+    std::vector<float_array> columns;
+    basis_list tables;
+    std::vector<solve_job> jobs;
+    for (py::handle item : tracks) {
+        py::sequence track = item.cast<py::sequence>();
+        if (track.size() != 4)
+            throw std::invalid_argument(
+                "each track must be (ownship_x, ownship_y, measure, "
+                "timeframe)");
+        float_array x = track[0].cast<float_array>();
+        float_array y = track[1].cast<float_array>();
+        float_array m = track[2].cast<float_array>();
+        float_array t = track[3].cast<float_array>();
+        int n = column_length(x, y, m, t);
+        jobs.push_back({x.data(), y.data(), m.data(), n,
+                        add_basis(tables, t, n), seed});
+        columns.push_back(x);
+        columns.push_back(y);
+        columns.push_back(m);
+        columns.push_back(t);
+    }
+    if (jobs.empty())
+        return py::list();
+    return run_and_collect(jobs, threads);
+}
+
+PYBIND11_MODULE(ACO_MODULE, m) {
+    m.doc() = "C++ ACO solver for bearings-only target motion analysis";
+    m.attr("DIMENSIONS") = DIMENSIONS;
+    m.attr("PARAM_SET") = PARAM_SET;
+    m.attr("NUM_ANTS") = NUM_ANTS;
+    m.attr("ITERATIONS") = ITERATIONS;
+
+    m.def("solve", &solve, py::arg("ownship_x"), py::arg("ownship_y"),
+          py::arg("measure"), py::arg("timeframe"), py::arg("seed") = 0,
+          "Run one ACO solve; returns (best_fitness, best_solution)");
+    m.def("solve_seeds", &solve_seeds, py::arg("ownship_x"),
+          py::arg("ownship_y"), py::arg("measure"), py::arg("timeframe"),
+          py::arg("seeds"), py::arg("threads") = 0,
+          "Solve one track once per seed in parallel; returns a list of "
+          "(best_fitness, best_solution)");
+    m.def("solve_tracks", &solve_tracks, py::arg("tracks"),
+          py::arg("seed") = 0, py::arg("threads") = 0,
+          "Solve (ownship_x, ownship_y, measure, timeframe) tracks in "
+          "parallel; returns a list of (best_fitness, best_solution)");
+}
@@ -0,0 +1,27 @@
+#!/bin/bash
+set -Eeuo pipefail
+trap 'echo "ERROR on line $LINENO"; exit 1' ERR
+
+# Builds the aco_native_d<DIMENSIONS>_p<PARAM_SET> extension modules used by
+# `aco.py --native`. Requires pybind11 (pip install pybind11).
+# Usage: ./build_native.sh [dimensions...]   (default: 4 6 8)
+
+dimensions=("$@")
+if [ ${#dimensions[@]} -eq 0 ]; then
+    dimensions=(4 6 8)
+fi
+
+includes=$(python3 -m pybind11 --includes)
+suffix=$(python3-config --extension-suffix)
+
+for numvars in "${dimensions[@]}"; do
+    for param_set in 0 1; do
+        module="aco_native_d${numvars}_p${param_set}"
+        echo "Compiling: $module"
+        c++ -O3 -shared -std=c++14 -fPIC -pthread $includes \
+            -DDIMENSIONS=$numvars -DPARAM_SET=$param_set -DACO_MODULE=$module \
+            aco_native.cpp ../cpp/aco.cpp ../cpp/prune.cpp -o "${module}${suffix}"
+    done
+done
+
+echo ">>> Native modules built in: $(pwd)"